@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "benchmark.hpp"
+
+namespace ipc::benchmark {
+
+/**
+ * Allocation benchmark counting the heap allocations of the read path per message.
+ * Allocations are counted by replacing the global operator new, which is only linked into the ipc-allocation
+ * executable. Memory allocated with malloc, e.g. by libdbus, is not counted.
+ */
+class AllocationBenchmark : public IBenchmark {
+public:
+    /// Amount of messages read before counting, so buffers can grow to their steady size.
+    static constexpr unsigned int WARMUP = 100;
+
+    /**
+     * Create new allocation benchmark with fixed amount of iterations and package size.
+     *
+     * @param iterations Number of iterations.
+     * @param size       Size of the package body.
+     * @param server     If the server side should be executed.
+     */
+    AllocationBenchmark(unsigned int iterations, unsigned int size, bool server);
+
+    bool setup(ICommunicationHandler &handler) override;
+
+    /**
+     * Run the current benchmark on the handler.
+     *
+     * @param handler Communication handler to run the tests on.
+     *
+     * @return True, if benchmark was successful and no allocation happened in steady state.
+     */
+    bool run(ICommunicationHandler &handler) override;
+
+    void cleanup(ICommunicationHandler &handler) override;
+
+    /**
+     * Check if the replaced operator new is linked, which counts the allocations.
+     *
+     * @return True, if allocations are counted.
+     */
+    static bool is_counting();
+
+    /**
+     * Amount of heap allocations with operator new of this process so far.
+     */
+    static std::size_t count_allocations();
+
+    /**
+     * Amount if iterations.
+     */
+    unsigned int get_iterations() const { return iterations_; }
+
+    /**
+     * Size of the body of one package.
+     */
+    unsigned int get_size() const { return size_; }
+
+    /**
+     * Amount if messages received. This value should match iterations.
+     */
+    unsigned int get_received() const { return received_; }
+
+    /**
+     * Amount of messages received after the warmup.
+     */
+    unsigned int get_counted() const { return received_ > WARMUP ? received_ - WARMUP : 0; }
+
+    /**
+     * Amount of heap allocations while reading after the warmup.
+     *
+     * @remarks Only valid if benchmark completed.
+     */
+    std::size_t get_allocations() const { return allocations_; }
+
+    /**
+     * Average amount of heap allocations per message after the warmup.
+     *
+     * @remarks Only valid if benchmark completed.
+     */
+    double get_allocations_per_message() const {
+        return get_counted() > 0 ? static_cast<double>(allocations_) / get_counted() : 0.0;
+    }
+
+private:
+    /**
+     * Run the server part of the benchmark.
+     *
+     * @param handler Communication handler to run the tests on.
+     *
+     * @return True, if benchmark was successful.
+     */
+    bool run_server(ICommunicationHandler &handler);
+
+    /**
+     * Run the client part of the benchmark.
+     *
+     * @param handler Communication handler to run the tests on.
+     *
+     * @return True, if benchmark was successful.
+     */
+    bool run_client(ICommunicationHandler &handler) const;
+
+private:
+    const unsigned int iterations_;
+    const unsigned int size_;
+    const bool server_;
+
+    unsigned int received_ = 0;
+    std::size_t allocations_ = 0;
+};
+
+}
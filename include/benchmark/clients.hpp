@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace ipc::benchmark {
+
+/**
+ * Benchmark of a server with many connected clients, which write at the same time.
+ * Measures the aggregated throughput and the latency of every client to detect unfair scheduling.
+ */
+class ClientsBenchmark : public IBenchmark {
+public:
+    /**
+     * Create new clients benchmark with fixed amount of iterations per client and package size.
+     *
+     * @param iterations Number of messages written by every client.
+     * @param size       Size of the package body, at least large enough for the index of the client.
+     * @param server     If the server side should be executed.
+     * @param clients    Amount of client processes.
+     * @remark Additional clients are forked and reopen the handler, so every client owns its connection.
+     */
+    ClientsBenchmark(unsigned int iterations, unsigned int size, bool server, unsigned int clients);
+
+    bool setup(ICommunicationHandler &handler) override;
+
+    bool run(ICommunicationHandler &handler) override;
+
+    void cleanup(ICommunicationHandler &handler) override;
+
+    /**
+     * Return the total amount if time in milliseconds for of the benchmark.
+     *
+     * @remarks Only valid if benchmark completed successfully.
+     */
+    double get_total_time() const { return static_cast<double>(end_time_ - start_time_) / 1000.0 / 1000.0; }
+
+    /**
+     * Return the aggregated throughput of all clients in KiB/s for of the benchmark.
+     *
+     * @remarks Only valid if benchmark completed successfully.
+     */
+    double get_throughput() const { return (received_ * size_ / 1024.0) / (get_total_time() / 1000.0); }
+
+    /**
+     * Return the latencies in nanoseconds of every client.
+     *
+     * @remarks Only valid if benchmark completed successfully.
+     */
+    const std::vector<std::vector<std::int64_t>> &get_results() const { return latencies_; }
+
+    /**
+     * Amount if iterations per client.
+     */
+    unsigned int get_iterations() const { return iterations_; }
+
+    /**
+     * Size of the body of one package.
+     */
+    unsigned int get_size() const { return size_; }
+
+    /**
+     * Amount of client processes.
+     */
+    unsigned int get_clients() const { return clients_; }
+
+    /**
+     * Amount if messages received. This value should match iterations times clients.
+     */
+    unsigned int get_received() const { return received_; }
+
+private:
+    /**
+     * Run the server part of the benchmark.
+     *
+     * @param handler Communication handler to run the tests on.
+     *
+     * @return True, if benchmark was successful.
+     */
+    bool run_server(ICommunicationHandler &handler);
+
+    /**
+     * Run the client part of the benchmark.
+     *
+     * @param handler Communication handler to run the tests on.
+     *
+     * @return True, if benchmark was successful.
+     */
+    bool run_client(ICommunicationHandler &handler) const;
+
+    /**
+     * Write messages as one of the clients.
+     *
+     * @param handler Communication handler to run the tests on.
+     * @param index   Index of the client, which is written in front of every body.
+     *
+     * @return True, if all messages were written.
+     */
+    bool run_writer(ICommunicationHandler &handler, std::uint32_t index) const;
+
+private:
+    const unsigned int iterations_;
+    const unsigned int size_;
+    const bool server_;
+    const unsigned int clients_;
+
+    std::int64_t start_time_ = 0;
+    std::int64_t end_time_ = 0;
+    unsigned int received_ = 0;
+    std::vector<std::vector<std::int64_t>> latencies_{};
+};
+
+}
@@ -17,8 +17,12 @@ public:
      * @param iterations Number of iterations.
      * @param delay      Delay in milliseconds between iterations.
      * @param server     If the server side should be executed.
+     * @param policy     Strategy of the reader to wait for new data.
+     * @param spin_count Amount of iterations to spin before blocking.
      */
-    LatencyBenchmark(unsigned int iterations, unsigned int delay, bool server);
+    LatencyBenchmark(unsigned int iterations, unsigned int delay, bool server,
+                     WaitPolicy policy = WaitPolicy::BLOCK,
+                     unsigned int spin_count = ICommunicationHandler::SPIN_COUNT);
 
     bool setup(ICommunicationHandler &handler) override;
 
@@ -43,6 +47,16 @@ public:
      */
     unsigned int get_delay() const { return delay_; }
 
+    /**
+     * Strategy of the reader to wait for new data.
+     */
+    WaitPolicy get_policy() const { return policy_; }
+
+    /**
+     * Amount of iterations to spin before blocking.
+     */
+    unsigned int get_spin_count() const { return spin_count_; }
+
 private:
     /**
      * Run the server part of the benchmark.
@@ -66,6 +80,8 @@ private:
     const unsigned int iterations_;
     const unsigned int delay_;
     const bool server_;
+    const WaitPolicy policy_;
+    const unsigned int spin_count_;
 
     std::vector<unsigned int> latencies_{};
 };
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "handler/communication_handler.hpp"
+#include "handler/reactor.hpp"
+
+namespace ipc::benchmark {
+
+/**
+ * Reactor benchmark measuring the throughput of a single reader, which waits for several handlers at once.
+ * Handlers with a descriptor are polled directly, the shared memory handlers are bridged by the reactor.
+ * Stream clients optionally reconnect during the benchmark, so the reader must accept them again.
+ */
+class ReactorBenchmark {
+public:
+    /**
+     * Create new reactor benchmark with fixed amount of iterations and package size.
+     *
+     * @param iterations Number of iterations per handler.
+     * @param size       Size of the package body.
+     * @param server     If the server side should be executed.
+     * @param reconnect  Amount of iterations, after which stream clients reconnect, or zero to never reconnect.
+     */
+    ReactorBenchmark(unsigned int iterations, unsigned int size, bool server, unsigned int reconnect);
+
+    /**
+     * Setup tests.
+     *
+     * @param handlers Communication handlers to run the tests on.
+     *
+     * @return True, if setup was successful.
+     */
+    bool setup(const std::vector<std::shared_ptr<ICommunicationHandler>> &handlers);
+
+    /**
+     * Run the current benchmark on the handlers.
+     *
+     * @param handlers Communication handlers to run the tests on.
+     *
+     * @return True, if benchmark was successful.
+     */
+    bool run(const std::vector<std::shared_ptr<ICommunicationHandler>> &handlers);
+
+    /**
+     * Cleanup tests.
+     *
+     * @param handlers Communication handlers to run the tests on.
+     */
+    void cleanup(const std::vector<std::shared_ptr<ICommunicationHandler>> &handlers);
+
+    /**
+     * Amount if iterations per handler.
+     */
+    unsigned int get_iterations() const { return iterations_; }
+
+    /**
+     * Size of the body of one package.
+     */
+    unsigned int get_size() const { return size_; }
+
+    /**
+     * Amount of iterations, after which stream clients reconnect.
+     */
+    unsigned int get_reconnect() const { return reconnect_; }
+
+    /**
+     * Amount if messages received. This value should match iterations times the amount of handlers.
+     */
+    unsigned int get_received() const { return received_; }
+
+    /**
+     * Amount of waits of the reactor, which reported at least one handler.
+     */
+    unsigned int get_waits() const { return waits_; }
+
+    /**
+     * Amount of connections closed by stream clients, including their final close.
+     */
+    unsigned int get_disconnects() const { return disconnects_; }
+
+    /**
+     * Total time between the first message and the last message in milliseconds.
+     *
+     * @remarks Only valid if benchmark completed.
+     */
+    double get_total_time() const { return static_cast<double>(end_time_ - start_time_) / 1000.0 / 1000.0; }
+
+    /**
+     * Throughput in KiB per second.
+     *
+     * @remarks Only valid if benchmark completed.
+     */
+    double get_throughput() const { return (received_ * size_ / 1024.0) / (get_total_time() / 1000.0); }
+
+private:
+    /**
+     * Run the server part of the benchmark.
+     *
+     * @param handlers Communication handlers to run the tests on.
+     *
+     * @return True, if benchmark was successful.
+     */
+    bool run_server(const std::vector<std::shared_ptr<ICommunicationHandler>> &handlers);
+
+    /**
+     * Run the client part of the benchmark.
+     *
+     * @param handlers Communication handlers to run the tests on.
+     *
+     * @return True, if benchmark was successful.
+     */
+    bool run_client(const std::vector<std::shared_ptr<ICommunicationHandler>> &handlers) const;
+
+    /**
+     * Read all messages of a handler reported by the reactor.
+     *
+     * @param handler Communication handler to read from.
+     *
+     * @return True, if no error occurred.
+     */
+    bool drain(ICommunicationHandler &handler);
+
+private:
+    const unsigned int iterations_;
+    const unsigned int size_;
+    const bool server_;
+    const unsigned int reconnect_;
+
+    Reactor reactor_{};
+    unsigned int received_ = 0;
+    unsigned int waits_ = 0;
+    unsigned int disconnects_ = 0;
+    std::int64_t start_time_ = 0;
+    std::int64_t end_time_ = 0;
+};
+
+}
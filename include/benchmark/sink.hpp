@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "benchmark.hpp"
+
+namespace ipc::benchmark {
+
+/**
+ * Sink benchmark measuring how fast the reader moves message bodies into a file or socket.
+ * The bodies are either copied through user space or spliced from the pipe of a fifo.
+ */
+class SinkBenchmark : public IBenchmark {
+public:
+    /**
+     * Create new sink benchmark with fixed amount of iterations and package size.
+     *
+     * @param iterations Number of iterations.
+     * @param size       Size of the package body.
+     * @param server     If the server side should be executed.
+     * @param splice     Whether to splice the bodies into the sink instead of copying them, only supported by fifos.
+     * @param path       Path of the file, which receives the bodies.
+     */
+    SinkBenchmark(unsigned int iterations, unsigned int size, bool server, bool splice,
+                  std::string path = "/dev/null");
+
+    bool setup(ICommunicationHandler &handler) override;
+
+    /**
+     * Run the current benchmark on the handler.
+     *
+     * @param handler Communication handler to run the tests on.
+     *
+     * @return True, if benchmark was successful.
+     */
+    bool run(ICommunicationHandler &handler) override;
+
+    void cleanup(ICommunicationHandler &handler) override;
+
+    /**
+     * Amount if iterations.
+     */
+    unsigned int get_iterations() const { return iterations_; }
+
+    /**
+     * Size of the body of one package.
+     */
+    unsigned int get_size() const { return size_; }
+
+    /**
+     * Whether the bodies are spliced instead of copied.
+     */
+    bool is_splice() const { return splice_; }
+
+    /**
+     * Path of the sink.
+     */
+    const std::string &get_path() const { return path_; }
+
+    /**
+     * Amount if messages received. This value should match iterations.
+     */
+    unsigned int get_received() const { return received_; }
+
+    /**
+     * Total time between the first message and the last body written into the sink in milliseconds.
+     *
+     * @remarks Only valid if benchmark completed.
+     */
+    double get_total_time() const { return static_cast<double>(end_time_ - start_time_) / 1000.0 / 1000.0; }
+
+    /**
+     * Throughput in KiB per second.
+     *
+     * @remarks Only valid if benchmark completed.
+     */
+    double get_throughput() const { return (received_ * size_ / 1024.0) / (get_total_time() / 1000.0); }
+
+private:
+    /**
+     * Run the server part of the benchmark.
+     *
+     * @param handler Communication handler to run the tests on.
+     *
+     * @return True, if benchmark was successful.
+     */
+    bool run_server(ICommunicationHandler &handler);
+
+    /**
+     * Run the client part of the benchmark.
+     *
+     * @param handler Communication handler to run the tests on.
+     *
+     * @return True, if benchmark was successful.
+     */
+    bool run_client(ICommunicationHandler &handler) const;
+
+    /**
+     * Read the next message and write its body into the sink.
+     *
+     * @param handler Communication handler to read from.
+     *
+     * @return Header of the message or an error.
+     */
+    std::variant<DataHeader, CommunicationError> transfer(ICommunicationHandler &handler) const;
+
+private:
+    const unsigned int iterations_;
+    const unsigned int size_;
+    const bool server_;
+    const bool splice_;
+    const std::string path_;
+
+    int fd_ = -1;
+    unsigned int received_ = 0;
+    std::int64_t start_time_ = 0;
+    std::int64_t end_time_ = 0;
+};
+
+}
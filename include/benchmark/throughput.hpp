@@ -17,8 +17,14 @@ public:
      * @param iterations Number of iterations.
      * @param size       Size of the package body.
      * @param server     If the server side should be executed.
+     * @param writers    Amount of writer processes sharing the iterations, at least one.
+     * @param batch      Amount of messages written and read per call, at least one, batch calls are only used if
+     *                   larger than one.
+     * @param view       Whether single messages are read as views into the receive buffer instead of owned objects.
+     * @remark Additional writers are forked and share the opened handler, so it must support concurrent writers.
      */
-    ThroughputBenchmark(unsigned int iterations, unsigned int size, bool server);
+    ThroughputBenchmark(unsigned int iterations, unsigned int size, bool server, unsigned int writers = 1,
+                        unsigned int batch = 1, bool view = false);
 
     bool setup(ICommunicationHandler &handler) override;
 
@@ -50,6 +56,21 @@ public:
      */
     unsigned int get_size() const { return size_; }
 
+    /**
+     * Amount of writer processes sharing the iterations.
+     */
+    unsigned int get_writers() const { return writers_; }
+
+    /**
+     * Amount of messages written and read per call.
+     */
+    unsigned int get_batch() const { return batch_; }
+
+    /**
+     * Whether single messages are read as views instead of owned objects.
+     */
+    bool is_view() const { return view_; }
+
     /**
      * Amount if messages received. This value should match iterations.
      */
@@ -74,10 +95,39 @@ private:
      */
     bool run_client(ICommunicationHandler &handler) const;
 
+    /**
+     * Write messages as one of the writer processes.
+     *
+     * @param handler    Communication handler to run the tests on.
+     * @param iterations Number of messages to write.
+     *
+     * @return True, if all messages were written.
+     */
+    bool run_writer(ICommunicationHandler &handler, unsigned int iterations) const;
+
+    /**
+     * Handle the header of a received message.
+     *
+     * @param header Header of the received message.
+     */
+    void receive(const DataHeader &header);
+
+    /**
+     * Handle an error while reading.
+     *
+     * @param error Error returned by the handler.
+     *
+     * @return True, if the error can be ignored.
+     */
+    bool handle_error(CommunicationError error) const;
+
 private:
     const unsigned int iterations_;
     const unsigned int size_;
     const bool server_;
+    const unsigned int writers_;
+    const unsigned int batch_;
+    const bool view_;
 
     std::int64_t start_time_ = 0;
     std::int64_t end_time_ = 0;
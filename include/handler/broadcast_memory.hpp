@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "communication_handler.hpp"
+#include "zero_copy_handler.hpp"
+
+namespace ipc {
+
+/**
+ * Shared memory ring with one writer and many readers, each reader sees every message.
+ * The writer publishes a sequence and every reader owns a cursor in the memory, the writer only waits on the slowest one.
+ */
+class BroadcastMemory : public ICommunicationHandler, public IZeroCopyHandler {
+public:
+    /// Size of a cache line to separate writer and reader data.
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    /// Total amount slots in the buffer (must be a power of two).
+    static constexpr std::uint32_t TOTAL_AMOUNT = 64;
+
+    /// Maximum amount of readers registered at the same time.
+    static constexpr std::uint32_t MAX_READERS = 16;
+
+    /// Size of the control block at the beginning of the memory.
+    static constexpr int CONTROL_SIZE = (1 + MAX_READERS) * CACHE_LINE_SIZE;
+
+    /// Total amount of memory to use.
+    static constexpr int TOTAL_SIZE = CONTROL_SIZE + BUFFER_SIZE * TOTAL_AMOUNT * sizeof(std::byte);
+
+    static_assert((TOTAL_AMOUNT & (TOTAL_AMOUNT - 1)) == 0, "Amount of slots must be a power of two");
+
+    /**
+     * Create a new broadcast shared memory handler.
+     *
+     * @param name   Name of the memory.
+     * @param reader Whether this handler reads messages, otherwise it is the only writer and manages the memory.
+     */
+    BroadcastMemory(std::string name, bool reader);
+
+    /**
+     * Destructor for this object to cleanup data and close memory.
+     */
+    ~BroadcastMemory() override;
+
+    bool open() override;
+
+    bool close() override;
+
+    bool is_open() const override;
+
+    bool await_data() override;
+
+    bool has_data() const override;
+
+    bool write(const IDataObject &obj) override;
+
+    std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
+
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    std::byte *reserve(unsigned int size) override;
+
+    bool commit(DataType type, unsigned int size) override;
+
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> peek() override;
+
+    /**
+     * Move the cursor of this reader forward and wake up the writer if it is sleeping.
+     */
+    void release() override;
+
+    /**
+     * Name of the memory.
+     */
+    const std::string &name() const { return name_; }
+
+    /**
+     * Whether is handler reads messages.
+     */
+    bool reader() const { return reader_; }
+
+private:
+    /// Cursor of a registered reader.
+    struct alignas(CACHE_LINE_SIZE) Cursor {
+        /// Process id of the reader, negative while it is joining, or zero if unused.
+        std::atomic<std::int32_t> owner;
+
+        /// Sequence of the next message to read.
+        std::atomic<std::uint32_t> sequence;
+    };
+
+    /// Control block shared between all processes.
+    struct Control {
+        /// Sequence of the next message to publish (written by the writer).
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> published;
+
+        /// Amount of readers sleeping on the published sequence.
+        std::atomic<std::uint32_t> readers_waiting;
+
+        /// Whether the writer is sleeping on this word.
+        std::atomic<std::uint32_t> writer_waiting;
+
+        /// Cursors of all readers.
+        Cursor cursors[MAX_READERS];
+    };
+
+    static_assert(sizeof(Control) == CONTROL_SIZE, "Size of control block should match");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "Atomics must be lock-free");
+
+    /**
+     * Get the address of the slot for a sequence.
+     *
+     * @param sequence Sequence of the slot.
+     *
+     * @return Address of the slot.
+     */
+    std::byte *slot(std::uint32_t sequence) const {
+        return &address_[CONTROL_SIZE + (sequence & (TOTAL_AMOUNT - 1)) * BUFFER_SIZE];
+    }
+
+    /**
+     * Register this reader with a cursor at the current head.
+     *
+     * @return True, if a free cursor was found.
+     */
+    bool register_reader();
+
+    /**
+     * Compute the sequence of the slowest registered reader.
+     *
+     * @param cleanup Whether to unregister readers whose process doesn't exist anymore.
+     *
+     * @return Sequence of the slowest reader or the published sequence if no reader is registered.
+     * @remark Joining readers count as lagging a whole ring behind, so the writer waits until they joined.
+     */
+    std::uint32_t slowest_reader(bool cleanup) const;
+
+private:
+    const std::string name_;
+    const bool reader_;
+    int fd_ = -1;
+    std::byte *address_ = nullptr;
+    Control *control_ = nullptr;
+    Cursor *cursor_ = nullptr;
+
+    std::uint32_t sequence_ = 0;
+    std::uint32_t cached_published_ = 0;
+    std::uint32_t cached_slowest_ = 0;
+
+    std::uint32_t reserved_ = 0;
+    bool peeked_ = false;
+    std::int64_t timestamp_ = 0;
+
+    std::uint32_t last_id_ = 0;
+    Fragmenter fragmenter_{};
+};
+
+}
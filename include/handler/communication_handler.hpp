@@ -1,13 +1,22 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <optional>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include "communication_error.hpp"
+#include "wait_policy.hpp"
 #include "object/data_header.hpp"
 #include "object/data_object.hpp"
 #include "object/binary_data.hpp"
+#include "object/binary_data_view.hpp"
 #include "object/java_symbol.hpp"
+#include "object/java_symbol_view.hpp"
 #include "object/ping.hpp"
 
 namespace ipc {
@@ -15,6 +24,55 @@ namespace ipc {
 /// Variant for all data types
 using DataObject = std::variant<Ping, JavaSymbol, BinaryData>;
 
+/// Variant for non-owning views of all data types
+using DataObjectView = std::variant<Ping, JavaSymbolView, BinaryDataView>;
+
+/**
+ * Create a non-owning view of a data object.
+ *
+ * @param obj Object to view, which must outlive the view.
+ *
+ * @return View of the object.
+ */
+inline DataObjectView view_data_object(const DataObject &obj) {
+    return std::visit([](const auto &data) -> DataObjectView {
+        using T = std::decay_t<decltype(data)>;
+
+        if constexpr (std::is_same_v<T, JavaSymbol>)
+            return JavaSymbolView(data);
+        else if constexpr (std::is_same_v<T, BinaryData>)
+            return BinaryDataView(data);
+        else
+            return data;
+    }, obj);
+}
+
+/**
+ * Copy the content of a view into a data object, reusing the memory of the object if it has the same type.
+ *
+ * @param obj  Object to copy the content into.
+ * @param view View to copy the content from.
+ */
+inline void assign_data_object(DataObject &obj, const DataObjectView &view) {
+    std::visit([&obj](const auto &data) {
+        using T = std::decay_t<decltype(data)>;
+
+        if constexpr (std::is_same_v<T, JavaSymbolView>) {
+            if (auto symbol = std::get_if<JavaSymbol>(&obj))
+                symbol->assign(data.get_address(), data.get_length(), data.get_symbol());
+            else
+                obj.emplace<JavaSymbol>(data.to_owned());
+        } else if constexpr (std::is_same_v<T, BinaryDataView>) {
+            if (auto binary = std::get_if<BinaryData>(&obj))
+                binary->assign(data.data(), data.size());
+            else
+                obj.emplace<BinaryData>(data.to_owned());
+        } else {
+            obj.emplace<T>(data);
+        }
+    }, view);
+}
+
 /**
  * Interface for all inter-process communication handlers.
  */
@@ -23,9 +81,21 @@ public:
     /// Size of the buffer and limit of header and body combined.
     static constexpr short BUFFER_SIZE = 512 + sizeof(DataHeader);
 
+    /// Limit of the body of a message, handlers with a smaller buffer split larger bodies into fragments.
+    static constexpr std::size_t MAX_BODY_SIZE = 32 * 1024 * 1024;
+
+    /// Minimum body size to pass the body as sealed memory file on handlers, which can pass file descriptors.
+    static constexpr std::size_t MEMORY_FILE_SIZE = 64 * 1024;
+
+    /// Maximum amount of parts for a message written with scatter-gather (header and body).
+    static constexpr unsigned int MAX_PARTS = 4;
+
     /// Time to wait for each poll in milliseconds.
     static constexpr short WAIT_TIME = 5000;
 
+    /// Default amount of iterations to spin before blocking.
+    static constexpr unsigned int SPIN_COUNT = 4096;
+
     virtual ~ICommunicationHandler() = default;
 
     /**
@@ -53,10 +123,31 @@ public:
      * Poll new data from the handler.
      *
      * @return True, if poll was successful.
-     * @remark Method will block until an event or timeout occurred.
+     * @remark Method will block until an event or timeout occurred, depending on the wait policy.
      */
     virtual bool await_data() = 0;
 
+    /**
+     * Configure how await_data waits for new data.
+     *
+     * @param policy     Strategy to wait for new data.
+     * @param spin_count Amount of iterations to spin before blocking (only used by WaitPolicy::SPIN).
+     */
+    void set_wait_policy(WaitPolicy policy, unsigned int spin_count = SPIN_COUNT) {
+        wait_policy_ = policy;
+        spin_count_ = spin_count;
+    }
+
+    /**
+     * Strategy to wait for new data.
+     */
+    WaitPolicy wait_policy() const { return wait_policy_; }
+
+    /**
+     * Amount of iterations to spin before blocking.
+     */
+    unsigned int spin_count() const { return spin_count_; }
+
     /**
      * Check if new data is available.
      *
@@ -64,6 +155,15 @@ public:
      */
     virtual bool has_data() const = 0;
 
+    /**
+     * Descriptor, which becomes readable once await_data would return without blocking.
+     *
+     * @return Pollable descriptor, or -1 if the handler waits on something else than a descriptor.
+     * @remark The descriptor may change while the handler accepts clients, so it must be queried again after waiting.
+     *         Data, which the handler already buffered, doesn't make it readable, so read until NO_DATA_AVAILABLE.
+     */
+    virtual int descriptor() const { return -1; }
+
     /**
      * Write a data object into the inter-process communication handler.
      *
@@ -79,6 +179,160 @@ public:
      * @return Objects received from the handler or an error.
      */
     virtual std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() = 0;
+
+    /**
+     * Read a data object from the inter-process communication handler without copying its data.
+     *
+     * @return View of the object received from the handler or an error.
+     * @remark The view points into the handler and is only valid until the next read.
+     */
+    virtual std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() {
+        // Fall back to an owned copy inside the handler
+        auto result = read();
+        if (std::holds_alternative<CommunicationError>(result))
+            return std::get<CommunicationError>(result);
+
+        auto &[header, obj] = std::get<std::tuple<DataHeader, DataObject>>(result);
+        owned_.emplace(std::move(obj));
+
+        return std::make_tuple(header, view_data_object(*owned_));
+    }
+
+    /**
+     * Read a data object from the inter-process communication handler into storage of the caller.
+     *
+     * @param obj Object to store the received data in, its memory is reused if the type matches.
+     *
+     * @return Header of the received object or an error.
+     * @remark Reusing the same object for every read avoids heap allocations in steady state.
+     */
+    virtual std::variant<DataHeader, CommunicationError> read_into(DataObject &obj) {
+        // Copy the content of the view into the storage of the caller
+        const auto result = read_view();
+        if (std::holds_alternative<CommunicationError>(result))
+            return std::get<CommunicationError>(result);
+
+        const auto &[header, view] = std::get<std::tuple<DataHeader, DataObjectView>>(result);
+        assign_data_object(obj, view);
+
+        return header;
+    }
+
+    /**
+     * Write multiple data objects into the inter-process communication handler at once.
+     *
+     * @param objects Objects to write into the handler in order.
+     *
+     * @return Amount of objects written, which is less than the amount of objects if an error occurred.
+     * @remark Handlers amortize syscalls and wakeups over the whole batch where possible.
+     */
+    virtual unsigned int write_batch(const std::vector<const IDataObject *> &objects) {
+        unsigned int written = 0;
+        for (const auto obj: objects) {
+            if (!write(*obj))
+                break;
+
+            written++;
+        }
+
+        return written;
+    }
+
+    /**
+     * Read multiple data objects from the inter-process communication handler at once.
+     *
+     * @param out Storage for the received objects, existing entries are overwritten and reused.
+     * @param max Maximum amount of objects to read.
+     *
+     * @return Amount of objects read into the first entries or an error, if no object could be read.
+     * @remark Method reads only available objects and stops at the first error. Entries behind the returned
+     *         amount are stale, so reusing the same vector avoids heap allocations in steady state.
+     */
+    virtual std::variant<unsigned int, CommunicationError> read_batch(
+            std::vector<std::tuple<DataHeader, DataObject>> &out, unsigned int max) {
+        unsigned int amount = 0;
+        while (amount < max) {
+            // Reuse the storage of existing entries
+            if (amount == out.size())
+                out.emplace_back(DataHeader(0, DataType::INVALID, 0, 0), Ping());
+
+            auto &[header, obj] = out[amount];
+            const auto result = read_into(obj);
+            if (std::holds_alternative<CommunicationError>(result)) {
+                if (amount == 0)
+                    return std::get<CommunicationError>(result);
+
+                break;
+            }
+
+            header = std::get<DataHeader>(result);
+            amount++;
+        }
+
+        return amount;
+    }
+
+protected:
+    /**
+     * Spin on a non-blocking check depending on the wait policy.
+     *
+     * @param check Non-blocking check if data is available.
+     *
+     * @return True, if data is available.
+     * @remark With WaitPolicy::BUSY_POLL this method spins until data is available or timeout occurred, with
+     *         WaitPolicy::POLL it checks only once.
+     */
+    template<typename F>
+    bool spin(F check) const {
+        switch (wait_policy_) {
+            case WaitPolicy::BLOCK:
+                return false;
+
+            case WaitPolicy::SPIN:
+                for (unsigned int i = 0; i < spin_count_; ++i) {
+                    if (check())
+                        return true;
+
+                    cpu_relax();
+                }
+                return false;
+
+            case WaitPolicy::POLL:
+                return check();
+
+            case WaitPolicy::BUSY_POLL: {
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(WAIT_TIME);
+                do {
+                    // Only check the clock every few iterations
+                    for (unsigned int i = 0; i < 64; ++i) {
+                        if (check())
+                            return true;
+
+                        cpu_relax();
+                    }
+                } while (std::chrono::steady_clock::now() < deadline);
+                return false;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Whether await_data may block once spinning found no data.
+     */
+    bool may_block() const { return wait_policy_ == WaitPolicy::BLOCK || wait_policy_ == WaitPolicy::SPIN; }
+
+    /**
+     * Time in milliseconds to wait for new clients, which is zero for WaitPolicy::POLL.
+     */
+    int accept_time() const { return wait_policy_ == WaitPolicy::POLL ? 0 : WAIT_TIME; }
+
+    WaitPolicy wait_policy_ = WaitPolicy::BLOCK;
+    unsigned int spin_count_ = SPIN_COUNT;
+
+private:
+    std::optional<DataObject> owned_{};
 };
 
 }
\ No newline at end of file
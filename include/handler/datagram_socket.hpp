@@ -6,22 +6,47 @@
 
 extern "C" {
 #include <netinet/in.h>
+#include <sys/socket.h>
 #include <sys/un.h>
 }
 
 #include "communication_handler.hpp"
+#include "fragmentation.hpp"
+#include "io_ring.hpp"
 
 namespace ipc {
 
+/**
+ * Datagram socket, which sends and receives batches of datagrams with a single call.
+ * Optionally all datagrams go through an io_uring, which receives them with a single multishot request.
+ */
 class DatagramSocket : public ICommunicationHandler {
 public:
+    /// Maximum amount of datagrams sent or received with a single call.
+    static constexpr unsigned int BATCH_SIZE = 32;
+
+    /// Amount of buffers the kernel selects from for received datagrams in io_uring mode.
+    static constexpr unsigned int RING_BUFFERS = 64;
+
+    /**
+     * Enumeration of the ways a datagram is moved through the socket.
+     */
+    enum class Mode {
+        /// Send and receive every datagram with its own syscall
+        PLAIN = 0,
+
+        /// Send and receive through an io_uring instead of separate syscalls
+        URING = 1
+    };
+
     /**
      * Create a new unix domain Socket.
      *
      * @param path   Path to the socket.
      * @param server Whether this socket is the server.
+     * @param mode   How datagrams are moved through the socket.
      */
-    DatagramSocket(std::string path, bool server);
+    DatagramSocket(std::string path, bool server, Mode mode = Mode::PLAIN);
 
     /**
      * Create a new internet domain Socket.
@@ -29,8 +54,9 @@ public:
      * @param address Internet address of the socket.
      * @param port    Port of the socket.
      * @param server  Whether this socket is the server.
+     * @param mode    How datagrams are moved through the socket.
      */
-    DatagramSocket(std::string address, std::uint16_t port, bool server);
+    DatagramSocket(std::string address, std::uint16_t port, bool server, Mode mode = Mode::PLAIN);
 
     /**
      * Destructor for this object to cleanup data and close socket.
@@ -47,10 +73,16 @@ public:
 
     bool has_data() const override;
 
+    int descriptor() const override;
+
     bool write(const IDataObject &obj) override;
 
     std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
 
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    unsigned int write_batch(const std::vector<const IDataObject *> &objects) override;
+
     /**
      * Path or address of the socket.
      */
@@ -71,6 +103,16 @@ public:
      */
     bool local() const { return unix_; }
 
+    /**
+     * How datagrams are moved through the socket.
+     */
+    Mode mode() const { return mode_; }
+
+    /**
+     * Whether is socket uses an io_uring.
+     */
+    bool uring() const { return uring_; }
+
 private:
     /**
      * Build addresses for server and client.
@@ -93,15 +135,65 @@ private:
      */
     bool create_client();
 
+    /**
+     * Receive the next message from the queue, which is refilled with a batch of datagrams if drained.
+     *
+     * @return Header and body of the message inside the queue or an error.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive();
+
+    /**
+     * Take the next datagram from the completions of the multishot receive.
+     *
+     * @return Datagram inside a buffer of the ring, which is given back on the next call, or an error.
+     */
+    std::variant<std::tuple<const std::byte *, std::size_t>, CommunicationError> receive_ring();
+
+    /**
+     * Start the multishot receive, which keeps receiving datagrams until it runs out of buffers.
+     *
+     * @return True, if the receive was submitted.
+     */
+    bool arm_ring();
+
+    /**
+     * Send prepared datagrams through the ring with a single submission.
+     *
+     * @param messages Datagrams to send.
+     * @param amount   Amount of datagrams.
+     *
+     * @return Amount of datagrams sent before the first error.
+     */
+    unsigned int send_ring(mmsghdr *messages, unsigned int amount);
+
 private:
     const std::tuple<std::string, std::optional<std::uint16_t>> parameters_;
     std::variant<sockaddr_un, sockaddr_in> address_;
     const bool server_;
     const bool unix_;
+    const Mode mode_;
+    const bool uring_;
     int sfd_ = -1;
 
     std::uint32_t last_id_ = 0;
     std::array<std::byte, BUFFER_SIZE> buffer_{};
+
+    std::array<std::byte, BUFFER_SIZE * BATCH_SIZE> send_buffer_{};
+    std::array<iovec, BATCH_SIZE * MAX_PARTS> send_vectors_{};
+    std::array<mmsghdr, BATCH_SIZE> send_messages_{};
+
+    std::array<std::byte, BUFFER_SIZE * BATCH_SIZE> receive_buffer_{};
+    std::array<iovec, BATCH_SIZE> receive_vectors_{};
+    std::array<mmsghdr, BATCH_SIZE> receive_messages_{};
+    unsigned int received_ = 0;
+    unsigned int next_ = 0;
+
+    IoRing ring_{};
+    std::uint32_t held_ = 0;
+    bool holding_ = false;
+
+    Fragmenter fragmenter_{};
+    Reassembler reassembler_{};
 };
 
 }
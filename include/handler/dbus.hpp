@@ -4,6 +4,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <tuple>
+#include <vector>
 
 extern "C" {
 #include <dbus/dbus.h>
@@ -24,13 +26,44 @@ public:
     /// Endpoint method name.
     static const inline std::string METHOD_NAME = "read";
 
+    /// Endpoint method name for multiple objects packed as array of structs.
+    static const inline std::string BATCH_METHOD_NAME = "read_batch";
+
+    /// Object path for batches, the type is part of every struct instead.
+    static const inline std::string BATCH_PATH = "/ipc/batch";
+
+    /// Signature of a single object inside a batch (id, type, timestamp, body).
+    static const inline std::string BATCH_ENTRY_SIGNATURE = "(uqxay)";
+
+    /// Maximum amount of body bytes packed into a single batch message.
+    static constexpr std::size_t MAX_BATCH_SIZE = 1024 * 1024;
+
+    /// Directory of the socket for peer-to-peer connections.
+    static const inline std::string PEER_DIRECTORY = "/tmp/";
+
+    /**
+     * Enumeration of the options of a dbus handler, which can be combined.
+     */
+    enum Option : unsigned int {
+        /// Pass large bodies as sealed memory file instead of a byte array
+        MEMORY_FILES = 1 << 0,
+
+        /// Connect directly through a unix socket instead of through the bus daemon
+        PEER = 1 << 1,
+
+        /// Pack batches into a single method call instead of one call per object
+        BATCHING = 1 << 2
+    };
+
     /**
      * Create a new dbus handler.
      *
-     * @param name   Name of the dbus.
-     * @param server Whether this dbus is the server.
+     * @param name    Name of the dbus.
+     * @param server  Whether this dbus is the server.
+     * @param options Combination of options, e.g. PEER | BATCHING.
+     * @remark Peer-to-peer servers accept a single client, which connects to the socket named after the dbus.
      */
-    DBus(std::string name, bool server);
+    DBus(std::string name, bool server, unsigned int options = 0);
 
     /**
      * Destructor for this object to cleanup data and close dbus.
@@ -47,10 +80,30 @@ public:
 
     bool has_data() const override;
 
+    int descriptor() const override;
+
     bool write(const IDataObject &obj) override;
 
     std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
 
+    /**
+     * Read a data object without copying its body out of the message.
+     *
+     * @return View of the object received from the handler or an error.
+     * @remark The view points into the received message or memory file and is only valid until the next read.
+     */
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    /**
+     * Write multiple data objects, which are packed into method calls of up to MAX_BATCH_SIZE if batching is enabled.
+     *
+     * @param objects Objects to write into the handler in order.
+     *
+     * @return Amount of objects written, which is less than the amount of objects if an error occurred.
+     * @remark Bodies, which are passed as memory file, are written with their own method call.
+     */
+    unsigned int write_batch(const std::vector<const IDataObject *> &objects) override;
+
     /**
      * Name of the DBus handler.
      */
@@ -61,6 +114,26 @@ public:
      */
     bool server() const { return server_; }
 
+    /**
+     * Whether large bodies are passed as sealed memory file.
+     */
+    bool memory_files() const { return memory_files_; }
+
+    /**
+     * Whether the dbus connects directly without the bus daemon.
+     */
+    bool peer() const { return peer_; }
+
+    /**
+     * Address of the peer-to-peer server.
+     */
+    std::string address() const { return "unix:path=" + PEER_DIRECTORY + name_; }
+
+    /**
+     * Whether batches are packed into a single method call.
+     */
+    bool batching() const { return batching_; }
+
 private:
     /**
      * Create dbus server.
@@ -76,14 +149,147 @@ private:
      */
     bool create_client();
 
+    /**
+     * Create peer-to-peer server, which listens for a client.
+     *
+     * @return True, if dbus server was created successfully.
+     */
+    bool create_peer_server();
+
+    /**
+     * Connect directly to a peer-to-peer server.
+     *
+     * @return True, if dbus client was created successfully.
+     */
+    bool create_peer_client();
+
+    /**
+     * Accept the client of the peer-to-peer server.
+     *
+     * @param timeout Time in milliseconds to wait for the client.
+     *
+     * @return True, if the client is connected.
+     */
+    bool accept(int timeout);
+
+    /**
+     * Read from the connection until a whole message is queued, as libdbus reads large messages in parts.
+     *
+     * @param timeout Time in milliseconds to wait, with zero only data, which is already readable, is taken.
+     *
+     * @return True, if a message is queued.
+     */
+    bool read_message(int timeout) const;
+
+    /**
+     * Object path of a type, which is built once for every type.
+     *
+     * @param type Type of the object.
+     *
+     * @return Path of the type.
+     */
+    static const std::string &object_path(DataType type);
+
+    /**
+     * Pack objects into a single batch message, until the message is full.
+     *
+     * @param objects Objects to write.
+     * @param offset  Index of the first object to pack.
+     *
+     * @return Amount of objects written.
+     */
+    unsigned int write_packed(const std::vector<const IDataObject *> &objects, std::size_t offset);
+
+    /**
+     * Serialize an object and append it as byte array.
+     *
+     * @param args Arguments of the message.
+     * @param obj  Object to append.
+     * @param size Size of the serialized object.
+     *
+     * @return True, if the object was appended successfully.
+     */
+    bool append_array(DBusMessageIter &args, const IDataObject &obj, std::size_t size);
+
+    /**
+     * Write the body into a sealed memory file and append its descriptor.
+     *
+     * @param args  Arguments of the message.
+     * @param parts Parts of the body, which are modified while writing.
+     * @param count Amount of parts.
+     *
+     * @return True, if the memory file was appended successfully.
+     */
+    bool append_memory_file(DBusMessageIter &args, iovec *parts, int count);
+
+    /**
+     * Receive the next object, which is either the next entry of the current batch or a new message.
+     *
+     * @return Header and body of the object inside the message or memory file, or an error.
+     * @remark The body is valid until the next receive.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive();
+
+    /**
+     * Parse the current entry of the batch.
+     *
+     * @return Header and body of the entry or an error.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive_entry();
+
+    /**
+     * Map the memory file of a message, which stays mapped until the next receive.
+     *
+     * @param args Arguments of the message pointing at the descriptor.
+     *
+     * @return Mapped body and its size, or an error.
+     */
+    std::variant<std::tuple<const std::byte *, std::size_t>, CommunicationError> map_memory_file(DBusMessageIter &args);
+
+    /**
+     * Release the current message and memory file.
+     */
+    void release();
+
+    /**
+     * Whether the current batch has entries, which were not received yet.
+     */
+    bool batch_pending() const;
+
+    /**
+     * Take the connection of a new client, later clients are dropped.
+     */
+    static void add_connection(DBusServer *server, DBusConnection *connection, void *data);
+
+    /**
+     * Remember the watch of the listening socket.
+     */
+    static dbus_bool_t add_watch(DBusWatch *watch, void *data);
+
+    /**
+     * Forget the watch of the listening socket.
+     */
+    static void remove_watch(DBusWatch *watch, void *data);
+
 private:
     const std::string name_;
     const bool server_;
+    const bool memory_files_;
+    const bool peer_;
+    const bool batching_;
 
     DBusConnection *con_ = nullptr;
+    DBusServer *listener_ = nullptr;
+    DBusWatch *watch_ = nullptr;
+
+    DBusMessage *message_ = nullptr;
+    DBusMessageIter entries_{};
+    bool batch_ = false;
+    const std::byte *mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
 
     std::uint32_t last_id_ = 0;
-    std::array<std::byte, BUFFER_SIZE> buffer_{};
+    std::vector<std::byte> buffer_ = std::vector<std::byte>(BUFFER_SIZE);
 };
 
 }
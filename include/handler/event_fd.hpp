@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+extern "C" {
+#include <sys/epoll.h>
+#include <sys/un.h>
+}
+
+#include "communication_handler.hpp"
+
+namespace ipc {
+
+/**
+ * Doorbell for pings, where the 64-bit counter of an eventfd is the whole message.
+ * Writers add to the counter and the reader takes it at once, so pings are batched by the kernel if the reader lags.
+ * The reader creates the eventfd and hands it to every writer through a unix socket at the given path.
+ */
+class EventFd : public ICommunicationHandler {
+public:
+    /// Maximum number of waiting writer connections.
+    static constexpr unsigned char BACKLOG = 5;
+
+    /**
+     * Create a new eventfd doorbell.
+     *
+     * @param path   Path to the socket, which passes the eventfd.
+     * @param server Whether this side creates the eventfd and reads.
+     */
+    EventFd(std::string path, bool server);
+
+    /**
+     * Destructor for this object to cleanup data and close eventfd.
+     */
+    ~EventFd() override;
+
+    bool open() override;
+
+    bool close() override;
+
+    bool is_open() const override;
+
+    bool await_data() override;
+
+    bool has_data() const override;
+
+    int descriptor() const override;
+
+    /**
+     * Ring the doorbell once.
+     *
+     * @param obj Object to write, which must be a ping.
+     *
+     * @return True, if the counter was increased.
+     */
+    bool write(const IDataObject &obj) override;
+
+    /**
+     * Take the next ping of the counter.
+     *
+     * @return Ping with the timestamp of the last write before the counter was taken, or an error.
+     * @remark Pings, which were batched by the kernel, share the same timestamp.
+     */
+    std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
+
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    /**
+     * Ring the doorbell for all objects with a single write.
+     *
+     * @param objects Objects to write, which must be pings.
+     *
+     * @return Amount of objects written, which is either all or zero.
+     */
+    unsigned int write_batch(const std::vector<const IDataObject *> &objects) override;
+
+    /**
+     * Add to the counter, so other channels can use the eventfd to wake the reader.
+     *
+     * @param count Amount of pings to signal.
+     *
+     * @return True, if the counter was increased.
+     */
+    bool notify(std::uint64_t count = 1);
+
+    /**
+     * Take the whole counter without returning pings, so other channels can reset their wake-up signal.
+     *
+     * @return Amount of pings taken, zero if none were pending or an error occurred.
+     */
+    std::uint64_t take();
+
+    /**
+     * Path of the socket.
+     */
+    const std::string &path() const { return path_; }
+
+    /**
+     * Whether this side creates the eventfd and reads.
+     */
+    bool server() const { return server_; }
+
+private:
+    /**
+     * Timestamp of the last write, shared between the reader and all writers.
+     */
+    struct Control {
+        std::atomic<std::int64_t> timestamp;
+    };
+
+    /**
+     * Create the eventfd and the socket, which passes it to the writers.
+     *
+     * @return True, if the eventfd was created successfully.
+     */
+    bool create_server();
+
+    /**
+     * Connect to the reader and receive the eventfd.
+     *
+     * @return True, if the eventfd was received successfully.
+     */
+    bool create_client();
+
+    /**
+     * Pass the eventfd and the control memory to all waiting writers.
+     */
+    void serve();
+
+    /**
+     * Take the counter, if no pings are pending.
+     *
+     * @return Nothing, if pings are pending, or an error.
+     */
+    std::optional<CommunicationError> receive();
+
+private:
+    const std::string path_;
+    sockaddr_un address_{};
+    const bool server_;
+    int efd_ = -1;
+    int sfd_ = -1;
+    int pfd_ = -1;
+    int mfd_ = -1;
+    Control *control_ = nullptr;
+
+    std::uint32_t last_id_ = 0;
+    std::uint64_t pending_ = 0;
+    std::int64_t timestamp_ = 0;
+    std::array<epoll_event, 2> events_{};
+};
+
+}
@@ -3,20 +3,56 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "communication_handler.hpp"
+#include "io_ring.hpp"
 
 namespace ipc {
 
 class Fifo : public ICommunicationHandler {
 public:
+    /// Initial size of the registered receive buffer in io_uring mode.
+    static constexpr std::size_t RING_BUFFER_SIZE = 64 * 1024;
+
+    /// Capacity of the pipe in splice and packet mode, unprivileged processes are limited by /proc/sys/fs/pipe-max-size.
+    static constexpr int PIPE_SIZE = 1024 * 1024;
+
+    /// Minimum size of a part, which is spliced instead of copied into the pipe.
+    static constexpr std::size_t SPLICE_THRESHOLD = 4096;
+
+    /// Initial size of the receive buffer in packet mode, which takes many packets or framed messages.
+    static constexpr std::size_t PACKET_BUFFER_SIZE = 64 * 1024;
+
+    /**
+     * Enumeration of the ways a message is moved through the pipe.
+     */
+    enum class Mode {
+        /// Write header and body with a single call and read them from the byte stream
+        PLAIN = 0,
+
+        /// Read and write through an io_uring instead of separate syscalls
+        URING = 1,
+
+        /// Splice large parts of the body into a larger pipe instead of copying them
+        SPLICE = 2,
+
+        /// Write small messages as packets, which are read with a single call each
+        PACKET = 3
+    };
+
     /**
      * Create a new Fifo pipe.
      *
      * @param path     Path to the pipe.
      * @param readonly Whether the pipe is for read only.
+     * @param mode     How messages are moved through the pipe.
+     * @remark In splice mode the pipe references the pages of the written objects, so their content must not
+     *         change until the reader consumed them. In packet mode large messages and batches are written as
+     *         byte stream and read as buffered framed messages, just like everything if the pipe doesn't support
+     *         packets.
      */
-    Fifo(std::string path, bool readonly);
+    Fifo(std::string path, bool readonly, Mode mode = Mode::PLAIN);
 
     /**
      * Destructor for this object to cleanup data and close pipe.
@@ -33,10 +69,26 @@ public:
 
     bool has_data() const override;
 
+    int descriptor() const override;
+
     bool write(const IDataObject &obj) override;
 
     std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
 
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    unsigned int write_batch(const std::vector<const IDataObject *> &objects) override;
+
+    /**
+     * Read the next message and move its body into a file or socket without copying it through user space.
+     *
+     * @param fd Descriptor of the file or socket, which receives the body.
+     *
+     * @return Header of the message or an error.
+     * @remark Not supported in io_uring mode, as the ring already read the data into its own buffer.
+     */
+    std::variant<DataHeader, CommunicationError> read_to(int fd);
+
     /**
      * Path of the pipe.
      */
@@ -47,13 +99,131 @@ public:
      */
     bool readonly() const { return readonly_; }
 
+    /**
+     * How messages are moved through the pipe.
+     */
+    Mode mode() const { return mode_; }
+
+    /**
+     * Whether is pipe uses an io_uring.
+     */
+    bool uring() const { return uring_; }
+
+    /**
+     * Whether is pipe splices large parts.
+     */
+    bool splice() const { return splice_; }
+
+    /**
+     * Whether is pipe writes and reads messages as packets.
+     */
+    bool packet() const { return packet_; }
+
+private:
+    /**
+     * Write all parts depending on the mode of the pipe.
+     *
+     * @param vectors Parts to write, which are adjusted while writing.
+     * @param count   Amount of parts.
+     *
+     * @return Amount of bytes written, or -1 for errors.
+     */
+    ssize_t write_vectors(iovec *vectors, int count);
+
+    /**
+     * Switch the writer between packets and a plain byte stream.
+     *
+     * @param enabled Whether the next writes are packets.
+     */
+    void set_packets(bool enabled);
+
+    /**
+     * Copy small parts and splice large parts into the pipe.
+     *
+     * @param vectors Parts to write, which are adjusted while writing.
+     * @param count   Amount of parts.
+     *
+     * @return Amount of bytes written, or -1 for errors.
+     */
+    ssize_t write_spliced(iovec *vectors, int count);
+
+    /**
+     * Receive the header of the next message.
+     *
+     * @return Header of the message or an error.
+     */
+    std::variant<DataHeader, CommunicationError> receive_header();
+
+    /**
+     * Receive the next message into the buffer.
+     *
+     * @return Header and body of the message inside the buffer or an error.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive();
+
+    /**
+     * Receive the next message from packets or framed messages, which are read into the buffer in one call.
+     *
+     * @return Header and body of the message inside the buffer or an error.
+     * @remark Incomplete messages stay buffered, so the reader never waits for the rest of a message.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive_packet();
+
+    /**
+     * Read an exact amount of bytes, waiting for the rest of a message which is written in multiple parts.
+     *
+     * @param buffer Buffer to read into.
+     * @param size   Amount of bytes to read.
+     *
+     * @return True, if all bytes were read before the wait time expired.
+     */
+    bool read_exactly(std::byte *buffer, std::size_t size);
+
+    /**
+     * Receive the next message from the data read by the ring.
+     *
+     * @return Header and body of the message inside the buffer or an error.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive_ring();
+
+    /**
+     * Submit a read behind the buffered data, unless one is already in flight.
+     * The buffer is compacted and grown for the buffered frame before, as it must not move while reading.
+     *
+     * @return True, if a read is in flight.
+     */
+    bool arm_ring();
+
+    /**
+     * Check if a complete frame is already buffered.
+     *
+     * @return True, if the next read doesn't have to wait for the ring.
+     */
+    bool buffered() const;
+
 private:
     const std::string path_;
     const bool readonly_;
+    const Mode mode_;
+    const bool uring_;
+    const bool splice_;
+    const bool packet_;
     int fd_ = -1;
 
     std::uint32_t last_id_ = 0;
     std::array<std::byte, BUFFER_SIZE> buffer_{};
+    std::vector<std::byte> batch_{};
+    std::vector<iovec> vectors_{};
+    std::vector<std::byte> receive_buffer_ = std::vector<std::byte>(BUFFER_SIZE);
+
+    IoRing ring_{};
+    std::size_t begin_ = 0;
+    std::size_t end_ = 0;
+    bool reading_ = false;
+    bool fixed_ = false;
+
+    int flags_ = -1;
+    bool direct_ = false;
 };
 
 }
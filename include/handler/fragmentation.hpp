@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+extern "C" {
+#include <sys/uio.h>
+}
+
+#include "communication_error.hpp"
+#include "communication_handler.hpp"
+#include "object/data_header.hpp"
+#include "object/data_object.hpp"
+#include "object/fragment.hpp"
+
+namespace ipc {
+
+/**
+ * Splits objects, which exceed the buffer of a handler, into fragments written as separate messages.
+ * The first fragment starts with a header of the whole message, so the receiver knows its type and size.
+ */
+class Fragmenter {
+public:
+    /**
+     * Describe an object as fragments, if its body exceeds the limit of a single message.
+     *
+     * @param obj   Object to split, which must not change until all fragments are written.
+     * @param limit Maximum size of the body of a single message.
+     *
+     * @return Amount of fragments, zero if the object fits into a single message or -1 if an error occurred.
+     */
+    int split(const IDataObject &obj, unsigned int limit);
+
+    /**
+     * Write all fragments of the last split object.
+     *
+     * @param handler Handler to write the fragments with, which must not split them again.
+     *
+     * @return True, if all fragments were written.
+     * @remark Every fragment is a message of its own, so the ids of the handler advance by the amount of fragments.
+     */
+    bool write(ICommunicationHandler &handler);
+
+private:
+    std::array<std::byte, ICommunicationHandler::BUFFER_SIZE> probe_{};
+    std::array<std::byte, ICommunicationHandler::BUFFER_SIZE> message_{};
+    std::array<iovec, ICommunicationHandler::MAX_PARTS> parts_{};
+    unsigned int count_ = 0;
+    std::size_t total_ = 0;
+    std::size_t chunk_ = 0;
+    Fragment fragment_{};
+};
+
+/**
+ * Collects fragments written by a Fragmenter until their message is complete.
+ */
+class Reassembler {
+public:
+    /**
+     * Add a fragment to the message, which is currently reassembled.
+     *
+     * @param header Header of the fragment.
+     * @param data   Body of the fragment.
+     *
+     * @return Header and body of the message once it is complete, NO_DATA_AVAILABLE while fragments are missing or
+     *         another error.
+     * @remark The body stays valid until the next fragment is added. If a fragment got lost, the whole message is
+     *         dropped.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> add(const DataHeader &header,
+                                                                                     const std::byte *data);
+
+    /**
+     * Receive messages until a message, which is not a fragment, or a reassembled message is available.
+     *
+     * @param next Function returning the next message of the transport.
+     *
+     * @return Header and body of the message or an error.
+     */
+    template<typename Receive>
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive(Receive &&next) {
+        while (true) {
+            const auto message = next();
+            if (std::holds_alternative<CommunicationError>(message))
+                return message;
+
+            const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+            if (header.get_type() != DataType::FRAGMENT)
+                return message;
+
+            // Continue with the next fragment while the message is incomplete
+            const auto result = add(header, data);
+            if (!std::holds_alternative<CommunicationError>(result)
+                || std::get<CommunicationError>(result) != CommunicationError::NO_DATA_AVAILABLE)
+                return result;
+        }
+    }
+
+private:
+    std::vector<std::byte> buffer_{};
+    std::size_t received_ = 0;
+    std::size_t expected_ = 0;
+    std::uint32_t id_ = 0;
+};
+
+}
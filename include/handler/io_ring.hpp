@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include <linux/io_uring.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+}
+
+namespace ipc {
+
+/**
+ * Minimal io_uring instance, which is driven by raw syscalls.
+ * Submissions are collected until they are submitted together and completions are drained without any syscall.
+ */
+class IoRing {
+public:
+    /// Default amount of submission entries.
+    static constexpr unsigned int ENTRIES = 64;
+
+    /// User data of writes issued by the ring itself, handlers use smaller values for their requests.
+    static constexpr std::uint64_t WRITE_DATA = 1ULL << 63;
+
+    /**
+     * Create a new closed ring.
+     */
+    IoRing() = default;
+
+    /**
+     * Destructor for this object to unregister buffers and close the ring.
+     */
+    ~IoRing();
+
+    IoRing(const IoRing &) = delete;
+
+    IoRing &operator=(const IoRing &) = delete;
+
+    /**
+     * Create the ring and map its queues.
+     *
+     * @param entries Amount of submission entries, the completion queue is twice as large.
+     *
+     * @return True, if the ring was created successfully.
+     */
+    bool open(unsigned int entries = ENTRIES);
+
+    /**
+     * Close the ring, requests which are still in flight are cancelled by the kernel.
+     */
+    void close();
+
+    /**
+     * Whether the ring is open.
+     */
+    bool is_open() const { return fd_ != -1; }
+
+    /**
+     * Descriptor of the ring, which is readable while completions are available.
+     */
+    int descriptor() const { return fd_; }
+
+    /**
+     * Get the next free submission entry, pending entries are submitted first if the queue is full.
+     *
+     * @param opcode Operation of the entry.
+     * @param fd     File descriptor of the operation.
+     * @param data   User data, which is returned with the completion.
+     *
+     * @return Cleared entry with opcode, fd and user data set, or nullptr if no entry is available.
+     */
+    io_uring_sqe *prepare(std::uint8_t opcode, int fd, std::uint64_t data);
+
+    /**
+     * Submit all prepared entries with a single call.
+     *
+     * @param wait Amount of completions to wait for.
+     *
+     * @return Amount of submitted entries, or -1 for errors.
+     */
+    int submit(unsigned int wait = 0);
+
+    /**
+     * Check if a completion is available without any syscall.
+     *
+     * @return True, if a completion can be peeked.
+     */
+    bool ready() const;
+
+    /**
+     * Submit prepared entries and wait for a completion.
+     *
+     * @param timeout Time in milliseconds to wait, or -1 for infinite.
+     *
+     * @return Returns 1 if a completion is available, zero if timed out, or -1 for errors.
+     */
+    int wait(int timeout);
+
+    /**
+     * Get the next completion without removing it.
+     *
+     * @return Next completion or nullptr if none is available.
+     */
+    const io_uring_cqe *peek() const;
+
+    /**
+     * Remove the peeked completion, so the kernel can reuse its entry.
+     */
+    void seen();
+
+    /**
+     * Wait until the completion of a request arrives and remove it, other completions stay available for peek.
+     *
+     * @param data User data of the request.
+     *
+     * @return Result of the request, or -errno if waiting failed.
+     * @remark Only usable for requests, which complete with a single completion.
+     */
+    int complete(std::uint64_t data);
+
+    /**
+     * Register buffers, so fixed reads and writes don't have to map them on every call.
+     *
+     * @param buffers Buffers to register, which must stay valid until the ring is closed.
+     * @param count   Amount of buffers.
+     *
+     * @return True, if the buffers were registered successfully.
+     */
+    bool register_buffers(const iovec *buffers, unsigned int count);
+
+    /**
+     * Provide a group of equally sized buffers, which the kernel selects for multishot receives.
+     *
+     * @param count Amount of buffers, must be a power of two.
+     * @param size  Size of every buffer.
+     *
+     * @return True, if the buffers were provided successfully.
+     */
+    bool provide_buffers(unsigned int count, unsigned int size);
+
+    /**
+     * Get a buffer selected by the kernel.
+     *
+     * @param flags Flags of the completion, which selected the buffer.
+     *
+     * @return Start of the buffer.
+     */
+    std::byte *provided(std::uint32_t flags) const;
+
+    /**
+     * Give a selected buffer back to the kernel.
+     *
+     * @param flags Flags of the completion, which selected the buffer.
+     */
+    void recycle(std::uint32_t flags);
+
+    /**
+     * Write all parts into a file descriptor through the ring, continuing after partial writes.
+     *
+     * @param fd      File descriptor to write into.
+     * @param vectors Parts to write, which are modified while writing.
+     * @param count   Amount of parts.
+     *
+     * @return Returns the total amount of bytes written, or -1 for errors.
+     * @remark Completions of other requests, which arrive in the meantime, are left in the queue.
+     */
+    ssize_t write_all(int fd, iovec *vectors, int count);
+
+private:
+    int fd_ = -1;
+
+    void *sq_address_ = nullptr;
+    std::size_t sq_size_ = 0;
+    void *cq_address_ = nullptr;
+    std::size_t cq_size_ = 0;
+    io_uring_sqe *sqes_ = nullptr;
+    std::size_t sqes_size_ = 0;
+
+    std::atomic<std::uint32_t> *sq_head_ = nullptr;
+    std::atomic<std::uint32_t> *sq_tail_ = nullptr;
+    std::uint32_t sq_mask_ = 0;
+    std::uint32_t sq_entries_ = 0;
+    std::uint32_t sqe_tail_ = 0;
+    std::uint32_t submitted_ = 0;
+
+    std::atomic<std::uint32_t> *cq_head_ = nullptr;
+    std::atomic<std::uint32_t> *cq_tail_ = nullptr;
+    std::uint32_t cq_mask_ = 0;
+    io_uring_cqe *cqes_ = nullptr;
+
+    io_uring_buf_ring *buffer_ring_ = nullptr;
+    std::byte *buffers_ = nullptr;
+    std::size_t buffers_size_ = 0;
+    unsigned int buffer_count_ = 0;
+    unsigned int buffer_size_ = 0;
+    std::uint16_t buffer_tail_ = 0;
+    bool registered_ = false;
+
+    std::uint64_t next_write_ = 0;
+    std::vector<io_uring_cqe> deferred_{};
+    std::size_t next_deferred_ = 0;
+};
+
+}
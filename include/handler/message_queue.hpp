@@ -1,21 +1,35 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 #include "communication_handler.hpp"
+#include "fragmentation.hpp"
 
 namespace ipc {
 
+/**
+ * Posix message queue, where every message is sent with the priority of its type, so pings overtake bulk data.
+ * Blocking readers wait inside the receive call, so a message is taken without polling the queue before.
+ */
 class MessageQueue : public ICommunicationHandler {
 public:
-    /// Amount of elements in the queue.
-    static constexpr short QUEUE_SIZE = 10;
+    /// Default amount of elements in the queue, which is the default limit for unprivileged processes.
+    static constexpr long QUEUE_SIZE = 10;
+
+    /// Maximum amount of elements in the queue, which is the hard limit of the kernel.
+    static constexpr long MAX_QUEUE_SIZE = 65536;
 
     /**
      * Create a new message queue.
      *
      * @param path     Path to the message queue.
      * @param readonly Whether the message queue is for read only.
+     * @param depth    Amount of elements in the queue, if it is created by this side.
+     * @remark The depth is reduced until the queue fits the limits in /proc/sys/fs/mqueue and RLIMIT_MSGQUEUE.
      */
-    MessageQueue(std::string path, bool readonly);
+    MessageQueue(std::string path, bool readonly, long depth = QUEUE_SIZE);
 
     /**
      * Destructor for this object to cleanup data and close message queue.
@@ -28,14 +42,24 @@ public:
 
     bool is_open() const override;
 
+    /**
+     * Wait for a message, blocking readers take it right away with a single call.
+     *
+     * @return True, if a message is available.
+     * @remark Views of the last read are only valid until the next await_data.
+     */
     bool await_data() override;
 
     bool has_data() const override;
 
+    int descriptor() const override;
+
     bool write(const IDataObject &obj) override;
 
     std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
 
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
     /**
      * Path of the message queue.
      */
@@ -46,13 +70,50 @@ public:
      */
     bool readonly() const { return readonly_; }
 
+    /**
+     * Amount of elements in the queue, which is the depth of the opened queue if it is open.
+     */
+    long depth() const { return depth_; }
+
+private:
+    /**
+     * Receive the next message into the buffer.
+     *
+     * @return Header and body of the message inside the buffer or an error.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive();
+
+    /**
+     * Take the next message from the queue into the buffer.
+     *
+     * @param timeout Time in milliseconds to wait for a message, zero returns immediately.
+     *
+     * @return True, if a message was taken.
+     */
+    bool take(int timeout);
+
+    /**
+     * Priority of messages of a type, higher priorities are received first.
+     *
+     * @param type Type of the message.
+     *
+     * @return Priority of the message.
+     * @remark Fragments share the priority of bulk data, so the fragments of a message keep their order.
+     */
+    static unsigned int priority(DataType type);
+
 private:
     const std::string path_;
     const bool readonly_;
+    long depth_;
     int mqd_ = -1;
 
     std::uint32_t last_id_ = 0;
     std::array<std::byte, BUFFER_SIZE> buffer_{};
+    ssize_t received_ = 0;
+
+    Fragmenter fragmenter_{};
+    Reassembler reassembler_{};
 };
 
 }
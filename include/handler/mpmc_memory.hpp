@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "communication_handler.hpp"
+#include "zero_copy_handler.hpp"
+
+namespace ipc {
+
+/**
+ * Shared memory queue for many writers and readers.
+ * Slots are claimed atomically and each slot carries a sequence stamp which tells if it is free or filled.
+ * Objects larger than a slot are rejected, fragments of concurrent writers and readers would interleave.
+ */
+class MpmcMemory : public ICommunicationHandler, public IZeroCopyHandler {
+public:
+    /// Size of a cache line to separate writer and reader data.
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    /// Total amount slots in the buffer (must be a power of two).
+    static constexpr std::uint32_t TOTAL_AMOUNT = 64;
+
+    /// Size of each slot including its sequence stamp, rounded to full cache lines.
+    static constexpr int SLOT_SIZE = (sizeof(std::uint64_t) + BUFFER_SIZE + CACHE_LINE_SIZE - 1)
+                                     / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+
+    /// Size of the control block at the beginning of the memory.
+    static constexpr int CONTROL_SIZE = 3 * CACHE_LINE_SIZE;
+
+    /// Total amount of memory to use.
+    static constexpr int TOTAL_SIZE = CONTROL_SIZE + SLOT_SIZE * TOTAL_AMOUNT;
+
+    static_assert((TOTAL_AMOUNT & (TOTAL_AMOUNT - 1)) == 0, "Amount of slots must be a power of two");
+
+    /**
+     * Create a new multi writer shared memory handler.
+     *
+     * @param name   Name area or file.
+     * @param server Whether is object manages the memory.
+     */
+    MpmcMemory(std::string name, bool server);
+
+    /**
+     * Destructor for this object to cleanup data and close memory.
+     */
+    ~MpmcMemory() override;
+
+    bool open() override;
+
+    bool close() override;
+
+    bool is_open() const override;
+
+    bool await_data() override;
+
+    bool has_data() const override;
+
+    bool write(const IDataObject &obj) override;
+
+    std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
+
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    std::byte *reserve(unsigned int size) override;
+
+    bool commit(DataType type, unsigned int size) override;
+
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> peek() override;
+
+    void release() override;
+
+    /**
+     * Name of the memory.
+     */
+    const std::string &name() const { return name_; }
+
+    /**
+     * Whether is handler manages the memory.
+     */
+    bool server() const { return server_; }
+
+private:
+    /// Slot with sequence stamp followed by the message.
+    struct Slot {
+        /// Equals the position if free for writing, position + 1 if filled for reading.
+        std::atomic<std::uint32_t> sequence;
+    };
+
+    /// Control block shared between all processes.
+    struct Control {
+        /// Position of the next slot to claim for writing.
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> enqueue_position;
+
+        /// Amount of writers sleeping on a full queue.
+        std::atomic<std::uint32_t> writers_waiting;
+
+        /// Futex word changed whenever slots are released.
+        std::atomic<std::uint32_t> space_signal;
+
+        /// Position of the next slot to claim for reading.
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> dequeue_position;
+
+        /// Amount of readers sleeping on an empty queue.
+        std::atomic<std::uint32_t> readers_waiting;
+
+        /// Futex word changed whenever slots are filled.
+        std::atomic<std::uint32_t> data_signal;
+
+        /// Id of the next message over all writers.
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> next_id;
+    };
+
+    static_assert(sizeof(Control) == CONTROL_SIZE, "Size of control block should match");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "Atomics must be lock-free");
+
+    /**
+     * Get the slot for a position.
+     *
+     * @param position Position of the slot.
+     *
+     * @return Slot for the position.
+     */
+    Slot *slot(std::uint32_t position) const {
+        return reinterpret_cast<Slot *>(&address_[CONTROL_SIZE + (position & (TOTAL_AMOUNT - 1)) * SLOT_SIZE]);
+    }
+
+    /**
+     * Get the message data of a slot.
+     *
+     * @param s Slot to get the data from.
+     *
+     * @return Address of the message.
+     */
+    static std::byte *data(Slot *s) {
+        return reinterpret_cast<std::byte *>(s) + sizeof(std::uint64_t);
+    }
+
+    /**
+     * Check if the slot at the current read position is filled.
+     *
+     * @return True, if data is available.
+     */
+    bool ready() const;
+
+private:
+    const std::string name_;
+    const bool server_;
+    int fd_ = -1;
+    std::byte *address_ = nullptr;
+    Control *control_ = nullptr;
+
+    Slot *reserved_ = nullptr;
+    std::uint32_t reserved_position_ = 0;
+    std::uint32_t reserved_size_ = 0;
+    std::int64_t timestamp_ = 0;
+
+    Slot *peeked_ = nullptr;
+    std::uint32_t peeked_position_ = 0;
+};
+
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <sys/epoll.h>
+}
+
+#include "communication_handler.hpp"
+
+namespace ipc {
+
+/**
+ * Event loop, which waits for any number of handlers with a single epoll_wait.
+ * Handlers with a descriptor are polled directly. Handlers, which wait on semaphores or futexes, are bridged by a
+ * thread, which rings an eventfd doorbell once their await_data returns.
+ *
+ * Handlers with a descriptor are checked with WaitPolicy::POLL once it becomes readable, so a handler, which only
+ * accepted a client or consumed a partial message, never blocks the others.
+ *
+ * Reported handlers must be read until NO_DATA_AVAILABLE before waiting again, as buffered data doesn't make their
+ * descriptor readable. Handlers must not be used while the reactor is waiting, as bridges may await them meanwhile.
+ */
+class Reactor {
+public:
+    /// Maximum amount of events taken from epoll with a single call.
+    static constexpr int MAX_EVENTS = 64;
+
+    /**
+     * Create a new closed reactor.
+     */
+    Reactor() = default;
+
+    /**
+     * Destructor for this object to stop all bridges and close epoll.
+     */
+    ~Reactor();
+
+    Reactor(const Reactor &) = delete;
+
+    Reactor &operator=(const Reactor &) = delete;
+
+    /**
+     * Create the epoll instance.
+     *
+     * @return True, if the reactor was opened successfully.
+     */
+    bool open();
+
+    /**
+     * Remove all handlers and close the epoll instance, the handlers themselves stay open.
+     *
+     * @return True, if the reactor was closed successfully.
+     * @remark Stopping a bridge waits for its pending await_data, which returns after WAIT_TIME at the latest.
+     */
+    bool close();
+
+    /**
+     * Check if the reactor is opened.
+     *
+     * @return True, if reactor is open.
+     */
+    bool is_open() const { return efd_ != -1; }
+
+    /**
+     * Register an open handler.
+     *
+     * @param handler Handler to wait for, which must outlive its registration.
+     *
+     * @return True, if the handler was registered successfully.
+     */
+    bool add(ICommunicationHandler &handler);
+
+    /**
+     * Unregister a handler.
+     *
+     * @param handler Handler to remove.
+     *
+     * @return True, if the handler was registered.
+     * @remark Stopping a bridge waits for its pending await_data, which returns after WAIT_TIME at the latest.
+     */
+    bool remove(ICommunicationHandler &handler);
+
+    /**
+     * Wait until at least one handler has data.
+     *
+     * @param timeout Time in milliseconds to wait, or -1 for infinite.
+     *
+     * @return Amount of handlers with data, zero if timed out, or -1 for errors.
+     */
+    int wait(int timeout);
+
+    /**
+     * Handlers with data, which were found by the last wait.
+     */
+    const std::vector<ICommunicationHandler *> &ready() const { return ready_; }
+
+    /**
+     * Amount of registered handlers.
+     */
+    std::size_t size() const { return entries_.size(); }
+
+private:
+    /**
+     * Thread, which awaits a handler without descriptor and rings an eventfd once it has data.
+     */
+    struct Bridge {
+        int doorbell = -1;
+        std::thread thread{};
+        std::mutex mutex{};
+        std::condition_variable condition{};
+        std::atomic<bool> armed = true;
+        bool stop = false;
+    };
+
+    /**
+     * Registration of a single handler.
+     */
+    struct Entry {
+        ICommunicationHandler *handler = nullptr;
+        int fd = -1;
+        std::unique_ptr<Bridge> bridge{};
+    };
+
+    /**
+     * Remove the old descriptor of a handler, if the handler switched to another one since the last wait.
+     *
+     * @param entry Registration of the handler.
+     */
+    void release(Entry &entry) const;
+
+    /**
+     * Register the current descriptor of a handler again. Closing a descriptor drops it from epoll, even if the
+     * handler reopened the same number meanwhile, so it is registered before every wait.
+     *
+     * @param entry Registration of the handler.
+     *
+     * @return True, if the descriptor is registered.
+     */
+    bool update(Entry &entry);
+
+    /**
+     * Create the bridge of a handler, which has no descriptor.
+     *
+     * @param entry Registration of the handler.
+     *
+     * @return True, if the bridge was started.
+     */
+    bool start_bridge(Entry &entry);
+
+    /**
+     * Stop the bridge of a handler and close its doorbell.
+     *
+     * @param entry Registration of the handler.
+     */
+    static void stop_bridge(Entry &entry);
+
+    /**
+     * Await the handler and ring the doorbell, every time the bridge is armed.
+     *
+     * @param handler Handler to await.
+     * @param bridge  Bridge of the handler.
+     */
+    static void run_bridge(ICommunicationHandler &handler, Bridge &bridge);
+
+private:
+    int efd_ = -1;
+    std::vector<std::unique_ptr<Entry>> entries_{};
+    std::vector<ICommunicationHandler *> ready_{};
+    std::array<epoll_event, MAX_EVENTS> events_{};
+};
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include <sys/socket.h>
+#include <sys/un.h>
+}
+
+#include "communication_handler.hpp"
+#include "fragmentation.hpp"
+
+namespace ipc {
+
+/**
+ * Unix sequenced packet socket, which keeps the boundaries of messages on a connection.
+ * Every message is a single packet, so the reader receives it with a single call and notices if the writer dies.
+ */
+class SeqPacketSocket : public ICommunicationHandler {
+public:
+    /// Maximum number of waiting socket connections.
+    static constexpr unsigned char BACKLOG = 5;
+
+    /// Maximum size of a single packet, larger messages are split into fragments.
+    static constexpr std::size_t PACKET_SIZE = 64 * 1024;
+
+    static_assert(PACKET_SIZE >= BUFFER_SIZE, "Packet must fit a small message");
+
+    /// Maximum amount of packets sent with a single call.
+    static constexpr unsigned int BATCH_SIZE = 32;
+
+    /**
+     * Create a new unix domain Socket.
+     *
+     * @param path   Path to the socket.
+     * @param server Whether this socket is the server.
+     */
+    SeqPacketSocket(std::string path, bool server);
+
+    /**
+     * Destructor for this object to cleanup data and close socket.
+     */
+    ~SeqPacketSocket() override;
+
+    bool open() override;
+
+    bool close() override;
+
+    bool is_open() const override;
+
+    /**
+     * Accept new clients.
+     *
+     * @return True, if a socket was accepted.
+     * @remark Method will block until an event occurred.
+     */
+    bool accept();
+
+    bool await_data() override;
+
+    bool has_data() const override;
+
+    int descriptor() const override;
+
+    bool write(const IDataObject &obj) override;
+
+    std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
+
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    unsigned int write_batch(const std::vector<const IDataObject *> &objects) override;
+
+    /**
+     * Path of the socket.
+     */
+    const std::string &path() const { return path_; }
+
+    /**
+     * Whether is socket is the server.
+     */
+    bool server() const { return server_; }
+
+private:
+    /**
+     * Create socket server.
+     *
+     * @return True, if socket server was created successfully.
+     */
+    bool create_server();
+
+    /**
+     * Create socket client.
+     *
+     * @return True, if socket client was created successfully.
+     */
+    bool create_client();
+
+    /**
+     * Receive the next packet with a single call.
+     *
+     * @return Header and body of the message inside the receive buffer or an error.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive();
+
+private:
+    const std::string path_;
+    sockaddr_un address_{};
+    const bool server_;
+    int sfd_ = -1;
+    int cfd_ = -1;
+
+    std::uint32_t last_id_ = 0;
+    std::array<std::byte, BUFFER_SIZE> buffer_{};
+
+    std::array<std::byte, BUFFER_SIZE * BATCH_SIZE> send_buffer_{};
+    std::array<iovec, BATCH_SIZE * MAX_PARTS> send_vectors_{};
+    std::array<mmsghdr, BATCH_SIZE> send_messages_{};
+
+    std::vector<std::byte> receive_buffer_ = std::vector<std::byte>(PACKET_SIZE);
+
+    Fragmenter fragmenter_{};
+    Reassembler reassembler_{};
+};
+
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <fstream>
 
 extern "C" {
@@ -7,6 +10,7 @@ extern "C" {
 }
 
 #include "communication_handler.hpp"
+#include "fragmentation.hpp"
 
 namespace ipc {
 
@@ -45,6 +49,8 @@ public:
 
     std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
 
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
     /**
      * Path of the file.
      */
@@ -55,6 +61,14 @@ public:
      */
     bool server() const { return server_; }
 
+private:
+    /**
+     * Receive the next message into the buffer.
+     *
+     * @return Header and body of the message inside the buffer or an error.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive();
+
 private:
     const std::string path_;
     const bool server_;
@@ -66,6 +80,9 @@ private:
 
     std::uint32_t last_id_ = 0;
     std::array<std::byte, BUFFER_SIZE> buffer_{};
+
+    Fragmenter fragmenter_{};
+    Reassembler reassembler_{};
 };
 
 }
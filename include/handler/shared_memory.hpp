@@ -1,20 +1,43 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
 extern "C" {
 #include <semaphore.h>
 }
 
 #include "communication_handler.hpp"
+#include "zero_copy_handler.hpp"
 
 namespace ipc {
 
-class SharedMemory : public ICommunicationHandler {
+/**
+ * Shared memory with a mirrored ring of variable sized messages.
+ * Positions are shared in the memory, semaphores are only used to wake up a waiting side.
+ */
+class SharedMemory : public ICommunicationHandler, public IZeroCopyHandler {
 public:
-    /// Total amount slots in the buffer.
-    static constexpr short TOTAL_AMOUNT = 64;
+    /// Size of a cache line to separate control data from messages.
+    static constexpr int CACHE_LINE_SIZE = 64;
+
+    /// Alignment of each message in the ring.
+    static constexpr int ALIGNMENT = 8;
+
+    /// Size of the ring for messages (must be a power of two).
+    static constexpr int RING_SIZE = 64 * 512 * sizeof(std::byte);
+
+    /// Size of the control block at the beginning of the memory (occupies a full page to align the ring).
+    static constexpr int CONTROL_SIZE = 4096;
 
     /// Total amount of memory to use.
-    static constexpr int TOTAL_SIZE = BUFFER_SIZE * TOTAL_AMOUNT * sizeof(std::byte);
+    static constexpr int TOTAL_SIZE = CONTROL_SIZE + RING_SIZE;
+
+    /// Amount of address space mapped, the ring is mapped twice back-to-back.
+    static constexpr int MAPPED_SIZE = TOTAL_SIZE + RING_SIZE;
+
+    static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "Size of the ring must be a power of two");
 
     /**
      * Create a new shared memory handler.
@@ -44,6 +67,21 @@ public:
 
     std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
 
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    unsigned int write_batch(const std::vector<const IDataObject *> &objects) override;
+
+    std::variant<unsigned int, CommunicationError> read_batch(
+            std::vector<std::tuple<DataHeader, DataObject>> &out, unsigned int max) override;
+
+    std::byte *reserve(unsigned int size) override;
+
+    bool commit(DataType type, unsigned int size) override;
+
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> peek() override;
+
+    void release() override;
+
     /**
      * Name or path of the memory.
      */
@@ -59,19 +97,77 @@ public:
      */
     bool file() const { return file_; }
 
+private:
+    /// Control block shared between both processes.
+    struct Control {
+        /// Position of the reader in the ring (written by the reader).
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> read_position;
+
+        /// Whether the writer is waiting for free space.
+        std::atomic<std::uint32_t> writer_waiting;
+
+        /// Position of the writer behind the last published message (written by the writer).
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> write_position;
+
+        /// Whether the reader is waiting for new messages.
+        std::atomic<std::uint32_t> reader_waiting;
+    };
+
+    static_assert(sizeof(Control) <= CONTROL_SIZE, "Size of control block should fit");
+
+    /**
+     * Size of a message in the ring including padding for the alignment.
+     *
+     * @param size Size of header and body.
+     *
+     * @return Aligned size of the message.
+     */
+    static constexpr std::uint32_t aligned(std::uint32_t size) {
+        return (size + ALIGNMENT - 1) & ~static_cast<std::uint32_t>(ALIGNMENT - 1);
+    }
+
+    /**
+     * Wait until enough space in the ring is available for the writer.
+     *
+     * @param size Amount of bytes to write.
+     *
+     * @return True, if space is available.
+     */
+    bool wait_for_space(std::uint32_t size);
+
+    /**
+     * Make all written messages visible and wake up the reader if it is waiting.
+     */
+    void publish();
+
+    /**
+     * Hand all released memory back and wake up the writer if it is waiting.
+     */
+    void free_space();
+
 private:
     const std::string name_;
     const bool server_;
     const bool file_;
     int fd_ = -1;
-    int offset_ = 0;
+    std::uint32_t offset_ = 0;
+    std::uint32_t read_position_ = 0;
+    std::uint32_t write_position_ = 0;
+    std::uint32_t published_ = 0;
+    std::uint32_t released_ = 0;
     std::byte *address_ = nullptr;
+    std::byte *ring_ = nullptr;
+    Control *control_ = nullptr;
 
     sem_t *reader_ = nullptr;
     sem_t *writer_ = nullptr;
 
+    std::uint32_t reserved_ = 0;
+    std::uint32_t peeked_ = 0;
+    std::int64_t timestamp_ = 0;
+
     std::uint32_t last_id_ = 0;
-    std::array<std::byte, BUFFER_SIZE> buffer_{};
+    Fragmenter fragmenter_{};
 };
 
 }
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "communication_handler.hpp"
+#include "event_fd.hpp"
+#include "zero_copy_handler.hpp"
+
+namespace ipc {
+
+/**
+ * Lock-free single producer single consumer ring in shared memory.
+ * The ring indices live inside the segment and peers are only woken up by a futex if they are sleeping.
+ * Optionally the consumer is woken up by an eventfd doorbell instead, which the reactor can poll directly.
+ */
+class SpscMemory : public ICommunicationHandler, public IZeroCopyHandler {
+public:
+    /// Size of a cache line to separate producer and consumer data.
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    /// Total amount slots in the buffer (must be a power of two).
+    static constexpr std::uint32_t TOTAL_AMOUNT = 64;
+
+    /// Size of the control block at the beginning of the memory.
+    static constexpr int CONTROL_SIZE = 2 * CACHE_LINE_SIZE;
+
+    /// Total amount of memory to use.
+    static constexpr int TOTAL_SIZE = CONTROL_SIZE + BUFFER_SIZE * TOTAL_AMOUNT * sizeof(std::byte);
+
+    static_assert((TOTAL_AMOUNT & (TOTAL_AMOUNT - 1)) == 0, "Amount of slots must be a power of two");
+
+    /**
+     * Create a new lock-free shared memory handler.
+     *
+     * @param name     Name area or file.
+     * @param server   Whether is object manages the memory.
+     * @param file     Whether the name is a path.
+     * @param doorbell Path of the socket passing an eventfd, which wakes the consumer instead of the futex, or empty.
+     * @remark The consumer must be opened before the producer, if a doorbell is used.
+     */
+    SpscMemory(std::string name, bool server, bool file = false, std::string doorbell = "");
+
+    /**
+     * Destructor for this object to cleanup data and close memory.
+     */
+    ~SpscMemory() override;
+
+    bool open() override;
+
+    bool close() override;
+
+    bool is_open() const override;
+
+    bool await_data() override;
+
+    bool has_data() const override;
+
+    /**
+     * Descriptor of the doorbell, which becomes readable once the producer rings it.
+     *
+     * @return Descriptor or -1, if no doorbell is used or this is the producer.
+     */
+    int descriptor() const override;
+
+    bool write(const IDataObject &obj) override;
+
+    std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
+
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    std::byte *reserve(unsigned int size) override;
+
+    bool commit(DataType type, unsigned int size) override;
+
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> peek() override;
+
+    void release() override;
+
+    /**
+     * Name or path of the memory.
+     */
+    const std::string &name() const { return name_; }
+
+    /**
+     * Whether is handler manages the memory.
+     */
+    bool server() const { return server_; }
+
+    /**
+     * Whether a mapped file is used.
+     */
+    bool file() const { return file_; }
+
+    /**
+     * Path of the doorbell socket or empty, if the futex is used.
+     */
+    const std::string &doorbell() const { return doorbell_path_; }
+
+private:
+    /// Control block shared between both processes.
+    struct Control {
+        /// Index of the next slot to write (written by the producer).
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> head;
+
+        /// Whether the consumer is sleeping on head, or armed the doorbell.
+        std::atomic<std::uint32_t> reader_waiting;
+
+        /// Index of the next slot to read (written by the consumer).
+        alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> tail;
+
+        /// Whether the producer is sleeping on tail.
+        std::atomic<std::uint32_t> writer_waiting;
+    };
+
+    static_assert(sizeof(Control) == CONTROL_SIZE, "Size of control block should match");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "Atomics must be lock-free");
+
+    /**
+     * Get the address of the slot for an index.
+     *
+     * @param index Ring index of the slot.
+     *
+     * @return Address of the slot.
+     */
+    std::byte *slot(std::uint32_t index) const {
+        return &address_[CONTROL_SIZE + (index & (TOTAL_AMOUNT - 1)) * BUFFER_SIZE];
+    }
+
+    /**
+     * Reset the doorbell and ask the producer to ring it for the next message.
+     *
+     * @return True, if data arrived meanwhile.
+     */
+    bool arm_doorbell();
+
+    /**
+     * Wait for the doorbell, the wait policy decides whether to block.
+     *
+     * @return True, if data is available.
+     */
+    bool await_doorbell();
+
+private:
+    const std::string name_;
+    const bool server_;
+    const bool file_;
+    const std::string doorbell_path_;
+    std::unique_ptr<EventFd> doorbell_{};
+    int fd_ = -1;
+    std::byte *address_ = nullptr;
+    Control *control_ = nullptr;
+
+    std::uint32_t head_ = 0;
+    std::uint32_t tail_ = 0;
+    std::uint32_t cached_head_ = 0;
+    std::uint32_t cached_tail_ = 0;
+
+    std::uint32_t reserved_ = 0;
+    bool peeked_ = false;
+    std::int64_t timestamp_ = 0;
+
+    std::uint32_t last_id_ = 0;
+    Fragmenter fragmenter_{};
+};
+
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+extern "C" {
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+}
+
+#include "communication_handler.hpp"
+
+namespace ipc {
+
+/**
+ * Stream socket server, which keeps many clients connected and multiplexes them through a single epoll instance.
+ * Clients are regular StreamSocket clients. Readable connections are served round-robin with one message each,
+ * so a busy client can't starve the others.
+ */
+class StreamServer : public ICommunicationHandler {
+public:
+    /// Maximum number of waiting socket connections.
+    static constexpr int BACKLOG = 128;
+
+    /// Maximum amount of events taken from epoll with a single call.
+    static constexpr int MAX_EVENTS = 64;
+
+    /// Initial size of the receive buffer of every client.
+    static constexpr std::size_t RECEIVE_SIZE = 64 * 1024;
+
+    static_assert(RECEIVE_SIZE >= BUFFER_SIZE, "Receive buffer must fit a small frame");
+
+    /**
+     * Create a new unix domain Server.
+     *
+     * @param path Path to the socket.
+     */
+    explicit StreamServer(std::string path);
+
+    /**
+     * Create a new internet domain Server.
+     *
+     * @param address Internet address of the socket.
+     * @param port    Port of the socket.
+     */
+    StreamServer(std::string address, std::uint16_t port);
+
+    /**
+     * Destructor for this object to cleanup data and close all sockets.
+     */
+    ~StreamServer() override;
+
+    bool open() override;
+
+    bool close() override;
+
+    bool is_open() const override;
+
+    bool await_data() override;
+
+    bool has_data() const override;
+
+    int descriptor() const override;
+
+    /**
+     * The server only receives, so writing always fails.
+     */
+    bool write(const IDataObject &obj) override;
+
+    std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
+
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    /**
+     * Path or address of the socket.
+     */
+    const std::string &path() const { return std::get<0>(parameters_); }
+
+    /**
+     * Port of the socket if internet domain socket.
+     */
+    std::optional<std::uint16_t> port() const { return std::get<1>(parameters_); }
+
+    /**
+     * Whether is socket is local.
+     */
+    bool local() const { return unix_; }
+
+    /**
+     * Amount of connected clients.
+     */
+    std::size_t clients() const { return clients_.size(); }
+
+private:
+    /**
+     * Connection of a single client with its own frame buffer.
+     */
+    struct Client {
+        int fd = -1;
+        bool readable = false;
+        std::vector<std::byte> buffer = std::vector<std::byte>(RECEIVE_SIZE);
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    /**
+     * Create socket server and register it at epoll.
+     *
+     * @return True, if socket server was created successfully.
+     */
+    bool create_server();
+
+    /**
+     * Take events from epoll, accept new clients and mark readable clients.
+     *
+     * @param timeout Time in milliseconds to wait for events.
+     *
+     * @return Amount of events, or -1 for errors.
+     */
+    int poll_events(int timeout);
+
+    /**
+     * Accept all waiting clients.
+     */
+    void accept_clients();
+
+    /**
+     * Close a client and remove it, the order of the other clients is kept.
+     *
+     * @param index Index of the client.
+     */
+    void remove_client(std::size_t index);
+
+    /**
+     * Check if any client has a complete frame buffered or is readable.
+     *
+     * @return True, if the next read may return a message.
+     */
+    bool pending() const;
+
+    /**
+     * Receive the next frame of a client, its socket is read at most once.
+     *
+     * @param client Client to receive from.
+     *
+     * @return Header and body of the message inside the buffer of the client or an error.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive(Client &client);
+
+    /**
+     * Receive the next frame from the clients in round-robin order.
+     *
+     * @return Header and body of the message inside the buffer of a client or an error.
+     * @remark The body is valid until the next read.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive();
+
+    /**
+     * Check if a complete frame of a client is already buffered.
+     *
+     * @param client Client to check.
+     *
+     * @return True, if the next read of the client doesn't need to receive data.
+     */
+    static bool buffered(const Client &client);
+
+private:
+    const std::tuple<std::string, std::optional<std::uint16_t>> parameters_;
+    std::variant<sockaddr_un, sockaddr_in> address_;
+    const bool unix_;
+    int sfd_ = -1;
+    int efd_ = -1;
+
+    std::vector<std::unique_ptr<Client>> clients_{};
+    std::size_t next_ = 0;
+    std::array<epoll_event, MAX_EVENTS> events_{};
+};
+
+}
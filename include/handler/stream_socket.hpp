@@ -7,10 +7,13 @@
 
 extern "C" {
 #include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 }
 
 #include "communication_handler.hpp"
+#include "io_ring.hpp"
 
 namespace ipc {
 
@@ -19,13 +22,42 @@ public:
     /// Maximum number of waiting socket connections.
     static constexpr unsigned char BACKLOG = 5;
 
+    /// Initial size of the receive buffer, which is filled with as many frames as possible per call.
+    static constexpr std::size_t RECEIVE_SIZE = 64 * 1024;
+
+    static_assert(RECEIVE_SIZE >= BUFFER_SIZE, "Receive buffer must fit a small frame");
+
+    /// Maximum amount of received memory files waiting for their frame.
+    static constexpr std::size_t MAX_FILES = 8;
+
+    /// Amount of buffers the kernel selects from for received data in io_uring mode.
+    static constexpr unsigned int RING_BUFFERS = 16;
+
+    /// Size of every buffer for received data in io_uring mode.
+    static constexpr unsigned int RING_BUFFER_SIZE = 16 * 1024;
+
+    /**
+     * Enumeration of the ways a message is moved through the socket.
+     */
+    enum class Mode {
+        /// Write header and body with a single call into the socket
+        PLAIN = 0,
+
+        /// Pass large bodies as sealed memory file instead of writing them into the socket
+        MEMORY_FILES = 1,
+
+        /// Send and receive through an io_uring instead of separate syscalls
+        URING = 2
+    };
+
     /**
      * Create a new unix domain Socket.
      *
      * @param path   Path to the socket.
      * @param server Whether this socket is the server.
+     * @param mode   How messages are moved through the socket.
      */
-    StreamSocket(std::string path, bool server);
+    StreamSocket(std::string path, bool server, Mode mode = Mode::PLAIN);
 
     /**
      * Create a new internet domain Socket.
@@ -33,8 +65,10 @@ public:
      * @param address Internet address of the socket.
      * @param port    Port of the socket.
      * @param server  Whether this socket is the server.
+     * @param mode    How messages are moved through the socket.
+     * @remark Memory files can only be passed through unix domain sockets, so opening fails in this mode.
      */
-    StreamSocket(std::string address, std::uint16_t port, bool server);
+    StreamSocket(std::string address, std::uint16_t port, bool server, Mode mode = Mode::PLAIN);
 
     /**
      * Destructor for this object to cleanup data and close socket.
@@ -59,10 +93,16 @@ public:
 
     bool has_data() const override;
 
+    int descriptor() const override;
+
     bool write(const IDataObject &obj) override;
 
     std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> read() override;
 
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> read_view() override;
+
+    unsigned int write_batch(const std::vector<const IDataObject *> &objects) override;
+
     /**
      * Path or address of the socket.
      */
@@ -83,6 +123,21 @@ public:
      */
     bool local() const { return unix_; }
 
+    /**
+     * How messages are moved through the socket.
+     */
+    Mode mode() const { return mode_; }
+
+    /**
+     * Whether large bodies are passed as sealed memory file.
+     */
+    bool memory_files() const { return memory_files_; }
+
+    /**
+     * Whether is socket uses an io_uring.
+     */
+    bool uring() const { return uring_; }
+
 private:
     /**
      * Build addresses for server.
@@ -105,16 +160,110 @@ private:
      */
     bool create_client();
 
+    /**
+     * Receive the next frame, the receive buffer is refilled only if no complete frame is buffered.
+     *
+     * @return Header and body of the message inside the receive buffer or an error.
+     * @remark Partial frames stay buffered and NO_DATA_AVAILABLE is returned until the rest arrives.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> receive();
+
+    /**
+     * Pass a large body as sealed memory file, only the headers are written into the socket.
+     *
+     * @param type      Type of the message.
+     * @param size      Size of the body.
+     * @param timestamp Timestamp of the message.
+     * @param parts     Parts of the body, which are modified while writing.
+     * @param count     Amount of parts.
+     *
+     * @return True, if the message was written successfully.
+     */
+    bool write_memory_file(DataType type, std::uint32_t size, std::int64_t timestamp, iovec *parts, int count);
+
+    /**
+     * Map the memory file of a received frame, the mapping is valid until the next frame is received.
+     *
+     * @param header Header of the frame.
+     * @param data   Body of the frame with the header of the passed body.
+     *
+     * @return Header of the message and the mapped body or an error.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> map_memory_file(
+            const DataHeader &header, const std::byte *data);
+
+    /**
+     * Collect the descriptors of memory files attached to received data.
+     *
+     * @param message Message returned by recvmsg.
+     */
+    void collect_memory_files(msghdr &message);
+
+    /**
+     * Unmap the last memory file and optionally close all descriptors waiting for their frame.
+     *
+     * @param pending Whether to close the waiting descriptors, too.
+     */
+    void release_memory_files(bool pending);
+
+    /**
+     * Append the data of the next completion of the multishot receive to the receive buffer.
+     *
+     * @return NO_DATA_AVAILABLE if no completion is available, CONNECTION_CLOSED if the peer closed the socket,
+     *         READ_ERROR for errors or no error if data was appended.
+     */
+    std::optional<CommunicationError> receive_ring();
+
+    /**
+     * Start the multishot receive on the client socket, which keeps receiving until it runs out of buffers.
+     *
+     * @return True, if the receive was submitted.
+     */
+    bool arm_ring();
+
+    /**
+     * Write all parts into the socket, either directly or through the ring.
+     *
+     * @param vectors Parts to write, which are modified while writing.
+     * @param count   Amount of parts.
+     *
+     * @return Returns the total amount of bytes written, or -1 for errors.
+     */
+    ssize_t write_vectors(iovec *vectors, int count);
+
+    /**
+     * Check if a complete frame is already buffered.
+     *
+     * @return True, if the next read doesn't need to receive data.
+     */
+    bool buffered() const;
+
 private:
     const std::tuple<std::string, std::optional<std::uint16_t>> parameters_;
     std::variant<sockaddr_un, sockaddr_in> address_;
     const bool server_;
     const bool unix_;
+    const Mode mode_;
+    const bool memory_files_;
+    const bool uring_;
     int sfd_ = -1;
     int cfd_ = -1;
 
     std::uint32_t last_id_ = 0;
     std::array<std::byte, BUFFER_SIZE> buffer_{};
+    std::vector<std::byte> batch_{};
+    std::vector<iovec> vectors_{};
+
+    std::vector<std::byte> receive_buffer_ = std::vector<std::byte>(RECEIVE_SIZE);
+    std::size_t begin_ = 0;
+    std::size_t end_ = 0;
+
+    std::array<int, MAX_FILES> files_{};
+    std::size_t file_count_ = 0;
+    const std::byte *mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
+
+    IoRing ring_{};
 };
 
 }
@@ -0,0 +1,33 @@
+#pragma once
+
+namespace ipc {
+
+/**
+ * Enumeration representing strategies to wait for new data.
+ */
+enum class WaitPolicy {
+    /// Block immediately until data is available or timeout
+    BLOCK = 0,
+
+    /// Spin a fixed amount of iterations before blocking
+    SPIN = 1,
+
+    /// Spin until data is available or timeout without blocking
+    BUSY_POLL = 2,
+
+    /// Check once without spinning or blocking
+    POLL = 3
+};
+
+/**
+ * Hint the processor that the current thread is spinning.
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+}
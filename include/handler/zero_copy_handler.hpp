@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <variant>
+
+#include "communication_error.hpp"
+#include "communication_handler.hpp"
+#include "fragmentation.hpp"
+#include "object/data_header.hpp"
+#include "utility.hpp"
+
+namespace ipc {
+
+/**
+ * Interface for handlers which can write and read messages in place without intermediate copies.
+ */
+class IZeroCopyHandler {
+public:
+    virtual ~IZeroCopyHandler() = default;
+
+    /**
+     * Reserve space for the body of the next message directly in the transport.
+     *
+     * @param size Maximum size of the body.
+     *
+     * @return Buffer to serialize the body into or nullptr if an error occurred.
+     * @remark Method will block until enough space is available. Each reserve must be followed by a commit.
+     */
+    virtual std::byte *reserve(unsigned int size) = 0;
+
+    /**
+     * Publish the reserved message.
+     *
+     * @param type Type of the message.
+     * @param size Actual size of the body, must not exceed the reserved size.
+     *
+     * @return True, if commit was successful.
+     */
+    virtual bool commit(DataType type, unsigned int size) = 0;
+
+    /**
+     * Get the next message without copying it out of the transport.
+     *
+     * @return Header and body of the message, which stay valid until release, or an error.
+     * @remark Calling this method again before release returns the same message.
+     */
+    virtual std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> peek() = 0;
+
+    /**
+     * Release the message returned by peek and hand its space back to the writer.
+     */
+    virtual void release() = 0;
+
+protected:
+    /**
+     * Peek the next message, fragments are collected and released until their message is complete.
+     *
+     * @return Header and body of the message, which stay valid until release, or an error.
+     */
+    std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> peek_message() {
+        while (true) {
+            const auto message = peek();
+            if (std::holds_alternative<CommunicationError>(message))
+                return message;
+
+            const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+            if (header.get_type() != DataType::FRAGMENT)
+                return message;
+
+            // Fragments are copied out, so their space is handed back right away
+            const auto result = reassembler_.add(header, data);
+            release();
+
+            if (!std::holds_alternative<CommunicationError>(result)
+                || std::get<CommunicationError>(result) != CommunicationError::NO_DATA_AVAILABLE)
+                return result;
+        }
+    }
+
+    /**
+     * Peek the next message and deserialize a view of it, the previously viewed message is released first.
+     *
+     * @return View of the object directly inside the transport or an error.
+     * @remark The view stays valid until the next read, read_view or release.
+     */
+    std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> peek_view() {
+        release_view();
+
+        const auto message = peek_message();
+        if (std::holds_alternative<CommunicationError>(message))
+            return std::get<CommunicationError>(message);
+
+        const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+        const auto body = deserialize_data_object_view(header.get_type(), data, header.get_body_size());
+        if (std::holds_alternative<CommunicationError>(body)) {
+            release();
+            return std::get<CommunicationError>(body);
+        }
+
+        viewed_ = true;
+        return std::make_tuple(header, std::get<DataObjectView>(body));
+    }
+
+    /**
+     * Release the message of the last view, if it wasn't released yet.
+     */
+    void release_view() {
+        if (viewed_) {
+            viewed_ = false;
+            release();
+        }
+    }
+
+private:
+    bool viewed_ = false;
+    Reassembler reassembler_{};
+};
+
+}
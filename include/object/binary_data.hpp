@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
 #include <ostream>
 #include <vector>
@@ -20,10 +21,20 @@ public:
      */
     explicit BinaryData(std::vector<std::byte> data);
 
+    BinaryData(const BinaryData &) = default;
+
+    BinaryData(BinaryData &&) noexcept = default;
+
+    BinaryData &operator=(const BinaryData &) = default;
+
+    BinaryData &operator=(BinaryData &&) noexcept = default;
+
     ~BinaryData() override = default;
 
     int serialize(std::byte *buffer, unsigned int size) const override;
 
+    int serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const override;
+
     DataType get_type() const override { return DataType::BINARY_DATA; };
 
     /**
@@ -31,6 +42,14 @@ public:
      */
     const std::vector<std::byte> &get_data() const { return data_; }
 
+    /**
+     * Replace the data of this object, reusing the already allocated memory if possible.
+     *
+     * @param data Pointer to the new data.
+     * @param size Size of the new data.
+     */
+    void assign(const std::byte *data, std::size_t size) { data_.assign(data, data + size); }
+
     /**
      * Deserialize the object from a buffer.
      *
@@ -42,8 +61,7 @@ public:
     static std::optional<BinaryData> deserialize(const std::byte *buffer, unsigned int size);
 
 private:
-    const std::vector<std::byte> data_;
-
+    std::vector<std::byte> data_;
 };
 
 std::ostream &operator<<(std::ostream &outs, const BinaryData &data);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+
+#include "binary_data.hpp"
+#include "data_object.hpp"
+
+namespace ipc {
+
+/**
+ * Non-owning view of binary data, pointing directly into a receive buffer.
+ */
+class BinaryDataView : public IDataObject {
+public:
+    /**
+     * Create a new view of binary data.
+     *
+     * @param data Pointer to the binary data.
+     * @param size Size of the binary data.
+     */
+    BinaryDataView(const std::byte *data, std::size_t size);
+
+    /**
+     * Create a new view of an owning binary data object.
+     *
+     * @param data Binary data object, which must outlive this view.
+     */
+    explicit BinaryDataView(const BinaryData &data);
+
+    ~BinaryDataView() override = default;
+
+    int serialize(std::byte *buffer, unsigned int size) const override;
+
+    int serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const override;
+
+    DataType get_type() const override { return DataType::BINARY_DATA; };
+
+    /**
+     * Pointer to the data of this view.
+     */
+    const std::byte *data() const { return data_; }
+
+    /**
+     * Size of the data of this view.
+     */
+    std::size_t size() const { return size_; }
+
+    /**
+     * Copy the viewed data into an owning object.
+     *
+     * @return Owning binary data object.
+     */
+    BinaryData to_owned() const;
+
+    /**
+     * Deserialize the view from a buffer without copying the data.
+     *
+     * @param buffer Buffer to deserialize the view from, which must outlive the view.
+     * @param size   Size of the buffer.
+     *
+     * @return Deserialized view into buffer.
+     */
+    static std::optional<BinaryDataView> deserialize(const std::byte *buffer, unsigned int size);
+
+private:
+    const std::byte *data_;
+    std::size_t size_;
+};
+
+std::ostream &operator<<(std::ostream &outs, const BinaryDataView &data);
+
+}
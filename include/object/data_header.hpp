@@ -22,7 +22,7 @@ public:
      * @param body_size Size of the actual message.
      * @param timestamp Timestamp when the message/header was created.
      */
-    DataHeader(std::uint32_t id, DataType type, std::uint16_t body_size, std::int64_t timestamp);
+    DataHeader(std::uint32_t id, DataType type, std::uint32_t body_size, std::int64_t timestamp);
 
     /**
      * Serialize the header into a buffer.
@@ -54,7 +54,7 @@ public:
     /**
      * Size of the actual message.
      */
-    std::uint16_t get_body_size() const { return body_size_; }
+    std::uint32_t get_body_size() const { return body_size_; }
 
     /**
      * Timestamp when the message/header was created.
@@ -74,7 +74,7 @@ public:
 private:
     std::uint32_t id_;
     DataType type_;
-    std::uint16_t body_size_;
+    std::uint32_t body_size_;
     std::int64_t timestamp_;
 };
 
@@ -2,6 +2,10 @@
 
 #include <cstddef>
 
+extern "C" {
+#include <sys/uio.h>
+}
+
 #include "data_type.hpp"
 
 namespace ipc {
@@ -26,6 +30,30 @@ public:
      */
     virtual int serialize(std::byte *buffer, unsigned int size) const = 0;
 
+    /**
+     * Describe the serialized object as parts, so large payloads can be written without copying them.
+     *
+     * @param buffer Buffer for small parts of the object, which must stay valid while the parts are used.
+     * @param size   Size of the buffer.
+     * @param parts  Array receiving the parts of the serialized object in order.
+     * @param count  Maximum amount of parts.
+     *
+     * @return Amount of parts used or -1 if an error occurred.
+     * @remark Parts may point into the object itself, so it must not change while the parts are used.
+     */
+    virtual int serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const {
+        if (count == 0)
+            return -1;
+
+        // Serialize the whole object into the buffer by default
+        const auto res = serialize(buffer, size);
+        if (res == -1)
+            return -1;
+
+        parts[0] = {buffer, static_cast<std::size_t>(res)};
+        return 1;
+    }
+
     /**
      * Type of the object.
      */
@@ -19,6 +19,12 @@ enum class DataType : std::uint16_t {
 
     /// Type for Binary Data (ipc::BinaryData)
     BINARY_DATA = 3,
+
+    /// Type for fragments of larger messages (ipc::Fragment)
+    FRAGMENT = 4,
+
+    /// Type for bodies passed as sealed memory file, only the header of the body is sent inline
+    MEMORY_FILE = 5,
 };
 
 }
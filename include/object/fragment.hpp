@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "data_object.hpp"
+
+namespace ipc {
+
+/**
+ * Slice of a serialized message, which is too large to be written as a single message.
+ * The slice is prefixed with its offset inside the message, so the receiver can detect lost fragments.
+ */
+class Fragment : public IDataObject {
+public:
+    /// Size of the offset in front of each slice.
+    static constexpr unsigned int PREFIX_SIZE = sizeof(std::uint32_t);
+
+    /**
+     * Create a new empty fragment.
+     */
+    Fragment() = default;
+
+    ~Fragment() override = default;
+
+    /**
+     * Select the slice of the message, which is described by this fragment.
+     *
+     * @param parts  Parts of the whole serialized message, which must stay valid while the fragment is used.
+     * @param count  Amount of parts.
+     * @param offset Offset of the slice inside the message.
+     * @param length Length of the slice.
+     */
+    void assign(const iovec *parts, unsigned int count, std::uint32_t offset, std::uint32_t length);
+
+    int serialize(std::byte *buffer, unsigned int size) const override;
+
+    int serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const override;
+
+    DataType get_type() const override { return DataType::FRAGMENT; };
+
+private:
+    const iovec *parts_ = nullptr;
+    unsigned int count_ = 0;
+    std::uint32_t offset_ = 0;
+    std::uint32_t length_ = 0;
+};
+
+}
@@ -3,6 +3,7 @@
 #include <optional>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "data_object.hpp"
@@ -23,10 +24,20 @@ public:
      */
     JavaSymbol(std::uint64_t address, std::uint32_t length, std::string symbol);
 
+    JavaSymbol(const JavaSymbol &) = default;
+
+    JavaSymbol(JavaSymbol &&) noexcept = default;
+
+    JavaSymbol &operator=(const JavaSymbol &) = default;
+
+    JavaSymbol &operator=(JavaSymbol &&) noexcept = default;
+
     ~JavaSymbol() override = default;
 
     int serialize(std::byte *buffer, unsigned int size) const override;
 
+    int serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const override;
+
     inline DataType get_type() const override { return DataType::JAVA_SYMBOL_LOOKUP; };
 
     /**
@@ -44,6 +55,19 @@ public:
      */
     const std::string &get_symbol() const { return symbol_; }
 
+    /**
+     * Replace the content of this object, reusing the already allocated memory of the name if possible.
+     *
+     * @param address Address of the symbol.
+     * @param length  Length of the symbol address area.
+     * @param symbol  Name of the symbol.
+     */
+    void assign(std::uint64_t address, std::uint32_t length, std::string_view symbol) {
+        address_ = address;
+        length_ = length;
+        symbol_.assign(symbol);
+    }
+
     /**
      * Deserialize the object from a buffer.
      *
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+#include "data_object.hpp"
+#include "java_symbol.hpp"
+
+namespace ipc {
+
+/**
+ * Non-owning view of a Java Symbol, the name points directly into a receive buffer.
+ */
+class JavaSymbolView : public IDataObject {
+public:
+    /**
+     * Create a new view of a java symbol containing address area and name.
+     *
+     * @param address Address of the symbol.
+     * @param length  Length of the symbol address area.
+     * @param symbol  Name of the symbol.
+     */
+    JavaSymbolView(std::uint64_t address, std::uint32_t length, std::string_view symbol);
+
+    /**
+     * Create a new view of an owning java symbol object.
+     *
+     * @param symbol Java symbol object, which must outlive this view.
+     */
+    explicit JavaSymbolView(const JavaSymbol &symbol);
+
+    ~JavaSymbolView() override = default;
+
+    int serialize(std::byte *buffer, unsigned int size) const override;
+
+    int serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const override;
+
+    inline DataType get_type() const override { return DataType::JAVA_SYMBOL_LOOKUP; };
+
+    /**
+     * Address of the symbol.
+     */
+    std::uint64_t get_address() const { return address_; }
+
+    /**
+     * Length of the address area of the symbol.
+     */
+    std::uint32_t get_length() const { return length_; }
+
+    /**
+     * Name of the symbol.
+     */
+    std::string_view get_symbol() const { return symbol_; }
+
+    /**
+     * Copy the viewed symbol into an owning object.
+     *
+     * @return Owning java symbol object.
+     */
+    JavaSymbol to_owned() const;
+
+    /**
+     * Deserialize the view from a buffer without copying the name.
+     *
+     * @param buffer Buffer to deserialize the view from, which must outlive the view.
+     * @param size   Size of the buffer.
+     *
+     * @return Deserialized view into buffer.
+     */
+    static std::optional<JavaSymbolView> deserialize(const std::byte *buffer, unsigned int size);
+
+private:
+    std::uint64_t address_;
+    std::uint32_t length_;
+    std::string_view symbol_;
+};
+
+std::ostream &operator<<(std::ostream &outs, const JavaSymbolView &symbol);
+
+}
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 
+extern "C" {
+#include <sys/types.h>
+#include <sys/uio.h>
+}
+
 #include "handler/communication_handler.hpp"
 
 // helper type for the visitor
@@ -41,6 +47,89 @@ std::int64_t get_timestamp();
  */
 int poll(int fd, int timeout);
 
+/**
+ * Poll file descriptor until data can be written into it.
+ *
+ * @param fd      File descriptor to poll from.
+ * @param timeout Time in milliseconds to wait while polling, or -1 for infinite.
+ *
+ * @return Returns 1 if successful, zero if timed out, or -1 for errors.
+ */
+int poll_write(int fd, int timeout);
+
+/**
+ * Write all parts into a file descriptor, continuing after partial writes.
+ *
+ * @param fd      File descriptor to write into.
+ * @param vectors Parts to write, which are modified while writing.
+ * @param count   Amount of parts.
+ *
+ * @return Returns the total amount of bytes written, or -1 for errors.
+ */
+ssize_t write_all(int fd, iovec *vectors, int count);
+
+/**
+ * Skip parts which were written completely and adjust the partial one.
+ *
+ * @param vectors Parts which were written, moved to the first part with remaining data.
+ * @param count   Amount of parts.
+ * @param written Amount of bytes written.
+ *
+ * @return Amount of remaining parts.
+ */
+int advance_vectors(iovec *&vectors, int count, std::size_t written);
+
+/**
+ * Total size of all parts.
+ *
+ * @param vectors Parts to sum up.
+ * @param count   Amount of parts.
+ *
+ * @return Total size in bytes.
+ */
+std::size_t total_size(const iovec *vectors, int count);
+
+/**
+ * Create a sealed memory file containing all parts, so its content can't change after passing it to another process.
+ *
+ * @param vectors Parts to write into the file, which are modified while writing.
+ * @param count   Amount of parts.
+ *
+ * @return File descriptor of the memory file, or -1 for errors.
+ */
+int create_sealed_memory(iovec *vectors, int count);
+
+/**
+ * Map a memory file received from another process read only.
+ *
+ * @param fd   File descriptor of the memory file.
+ * @param size Amount of bytes to map.
+ *
+ * @return Address of the mapping, or nullptr if the file is not sealed, too small or can't be mapped.
+ */
+const std::byte *map_sealed_memory(int fd, std::size_t size);
+
+/**
+ * Wait on a futex word shared between processes.
+ *
+ * @param address  Address of the futex word.
+ * @param expected Value the word must still have to go to sleep.
+ * @param timeout  Time in milliseconds to wait, or -1 for infinite.
+ *
+ * @return Returns 0 if woken up, or -1 for errors, timeouts or changed values.
+ */
+int futex_wait(std::atomic<std::uint32_t> *address, std::uint32_t expected, int timeout);
+
+/**
+ * Wake processes waiting on a futex word shared between processes.
+ *
+ * @param address Address of the futex word.
+ * @param count   Maximum amount of processes to wake up.
+ *
+ * @return Returns the amount of processes woken up, or -1 for errors.
+ */
+int futex_wake(std::atomic<std::uint32_t> *address, int count);
+
 /**
  * Deserialize a DataObject from a buffer with given size.
  *
@@ -53,4 +142,16 @@ int poll(int fd, int timeout);
 std::variant<DataObject, CommunicationError> deserialize_data_object(
         DataType type, const std::byte *buffer, unsigned int size);
 
+/**
+ * Deserialize a non-owning view of a DataObject from a buffer with given size.
+ *
+ * @param type   Type of the object.
+ * @param buffer Buffer with serialized object data, which must outlive the view.
+ * @param size   Size of the buffer.
+ *
+ * @return Deserialized view or error.
+ */
+std::variant<DataObjectView, CommunicationError> deserialize_data_object_view(
+        DataType type, const std::byte *buffer, unsigned int size);
+
 }
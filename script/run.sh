@@ -1,7 +1,8 @@
 #!/bin/bash
 
 program=./cmake-build-release/ipc
-handlers=("dbus" "fifo" "queue" "dgram" "stream" "udp" "tcp" "memory" "mapped" "file")
+handlers=("dbus" "dbus-peer" "dbus-batch" "dbus-peer-batch" "fifo" "fifo-uring" "fifo-packet" "queue" "queue-deep" "dgram" "dgram-uring" "stream" "stream-uring" "seqpacket" "udp" "tcp" "memory" "mapped" "spsc" "spsc-mapped" "spsc-doorbell" "broadcast" "mpmc" "file")
+latency_handlers=("${handlers[@]}" "eventfd")
 
 cpu_reader=0
 cpu_writer=1
@@ -14,17 +15,20 @@ echo "Running latency benchmark"
 
 iterations=1000
 delay=10
+policies=("block" "spin" "busy")
 
-for handler in "${handlers[@]}"; do
-  echo "> Running $handler (single socket)"
+for handler in "${latency_handlers[@]}"; do
+  for policy in "${policies[@]}"; do
+    echo "> Running $handler (single socket, $policy)"
 
-  taskset -c "$cpu_reader" "$program" "latency" "$handler" "reader" "$iterations" "$delay" >> "$logs/latency_$handler""_reader.log" 2>&1 &
-  sleep 0.2 && taskset -c "$cpu_writer" "$program" "latency" "$handler" "writer" "$iterations" "$delay" >> "$logs/latency_$handler""_writer.log" 2>&1 &
+    taskset -c "$cpu_reader" "$program" "latency" "$handler" "reader" "$iterations" "$delay" "$policy" >> "$logs/latency_$handler""_$policy""_reader.log" 2>&1 &
+    sleep 0.2 && taskset -c "$cpu_writer" "$program" "latency" "$handler" "writer" "$iterations" "$delay" "$policy" >> "$logs/latency_$handler""_$policy""_writer.log" 2>&1 &
 
-  wait && sleep 1
+    wait && sleep 1
+  done
 done
 
-for handler in "${handlers[@]}"; do
+for handler in "${latency_handlers[@]}"; do
   echo "> Running $handler (dual socket)"
 
   taskset -c "$cpu_reader" "$program" "latency" "$handler" "reader" "$iterations" "$delay" >> "$logs/latency_$handler""_reader.log" 2>&1 &
@@ -49,6 +53,144 @@ for handler in "${handlers[@]}"; do
   done
 done
 
+echo "Running writer scaling benchmark"
+
+iterations=1000000
+size=128
+writers=(1 2 4 8)
+scaling_handlers=("queue" "queue-deep" "dgram" "mpmc")
+
+for handler in "${scaling_handlers[@]}"; do
+  for count in "${writers[@]}"; do
+    echo "> Running $handler with $count writers"
+
+    taskset -c "$cpu_reader" "$program" "throughput" "$handler" "reader" "$iterations" "$size" "$count" >> "$logs/scaling_$handler""_reader.log" 2>&1 &
+    sleep 0.2 && taskset -c "$cpu_writer-$((cpu_writer + count - 1))" "$program" "throughput" "$handler" "writer" "$iterations" "$size" "$count" >> "$logs/scaling_$handler""_writer.log" 2>&1 &
+
+    wait && sleep 1
+  done
+done
+
+echo "Running multi client benchmark"
+
+iterations=10000
+size=128
+clients=(1 2 4 8 16 32 64)
+client_handlers=("stream-multi" "tcp-multi")
+
+for handler in "${client_handlers[@]}"; do
+  for count in "${clients[@]}"; do
+    echo "> Running $handler with $count clients"
+
+    cpus=$((count < 16 ? count : 16))
+    taskset -c "$cpu_reader" "$program" "clients" "$handler" "reader" "$iterations" "$size" "$count" >> "$logs/clients_$handler""_reader.log" 2>&1 &
+    sleep 0.2 && taskset -c "$cpu_writer-$((cpu_writer + cpus - 1))" "$program" "clients" "$handler" "writer" "$iterations" "$size" "$count" >> "$logs/clients_$handler""_writer.log" 2>&1 &
+
+    wait && sleep 1
+  done
+done
+
+echo "Running reactor benchmark"
+
+iterations=100000
+size=128
+reconnects=(0 1000)
+reactor_handlers=("stream,dgram,memory,spsc-doorbell" "stream,tcp,spsc,mpmc")
+
+for handler in "${reactor_handlers[@]}"; do
+  for reconnect in "${reconnects[@]}"; do
+    echo "> Running $handler with reconnects every $reconnect messages"
+
+    taskset -c "$cpu_reader" "$program" "reactor" "$handler" "reader" "$iterations" "$size" "$reconnect" >> "$logs/reactor_$handler""_$reconnect""_reader.log" 2>&1 &
+    sleep 0.2 && taskset -c "$cpu_writer" "$program" "reactor" "$handler" "writer" "$iterations" "$size" "$reconnect" >> "$logs/reactor_$handler""_$reconnect""_writer.log" 2>&1 &
+
+    wait && sleep 1
+  done
+done
+
+echo "Running batch benchmark"
+
+iterations=1000000
+size=128
+batches=(1 4 16 64)
+
+for handler in "${handlers[@]}"; do
+  for batch in "${batches[@]}"; do
+    echo "> Running $handler with batches of $batch"
+
+    taskset -c "$cpu_reader" "$program" "throughput" "$handler" "reader" "$iterations" "$size" 1 "$batch" >> "$logs/batch_$handler""_reader.log" 2>&1 &
+    sleep 0.2 && taskset -c "$cpu_writer" "$program" "throughput" "$handler" "writer" "$iterations" "$size" 1 "$batch" >> "$logs/batch_$handler""_writer.log" 2>&1 &
+
+    wait && sleep 1
+  done
+done
+
+echo "Running view benchmark"
+
+iterations=100000
+sizes=(128 4096 65536)
+view_handlers=("fifo" "stream" "memory" "spsc")
+
+for handler in "${view_handlers[@]}"; do
+  for size in "${sizes[@]}"; do
+    echo "> Running $handler with $size Bytes (view)"
+
+    taskset -c "$cpu_reader" "$program" "throughput" "$handler" "reader" "$iterations" "$size" 1 1 "view" >> "$logs/view_$handler""_reader.log" 2>&1 &
+    sleep 0.2 && taskset -c "$cpu_writer" "$program" "throughput" "$handler" "writer" "$iterations" "$size" 1 1 "view" >> "$logs/view_$handler""_writer.log" 2>&1 &
+
+    wait && sleep 1
+  done
+done
+
+echo "Running large message benchmark"
+
+iterations=100
+sizes=(4096 65536 1048576 16777216)
+large_handlers=("dbus" "dbus-memfd" "dbus-peer" "fifo" "fifo-uring" "fifo-splice" "fifo-packet" "queue" "dgram" "dgram-uring" "stream" "stream-memfd" "stream-uring" "seqpacket" "tcp" "memory" "mapped" "spsc" "spsc-mapped" "broadcast" "file")
+
+for handler in "${large_handlers[@]}"; do
+  for size in "${sizes[@]}"; do
+    echo "> Running $handler with $size Bytes"
+
+    taskset -c "$cpu_reader" "$program" "throughput" "$handler" "reader" "$iterations" "$size" >> "$logs/large_$handler""_reader.log" 2>&1 &
+    sleep 0.2 && taskset -c "$cpu_writer" "$program" "throughput" "$handler" "writer" "$iterations" "$size" >> "$logs/large_$handler""_writer.log" 2>&1 &
+
+    wait && sleep 1
+  done
+done
+
+echo "Running sink benchmark"
+
+iterations=100
+sizes=(65536 1048576)
+transfers=("copy" "splice")
+
+for transfer in "${transfers[@]}"; do
+  for size in "${sizes[@]}"; do
+    echo "> Running fifo-splice with $size Bytes ($transfer)"
+
+    taskset -c "$cpu_reader" "$program" "sink" "fifo-splice" "reader" "$iterations" "$size" "$transfer" >> "$logs/sink_fifo-splice_$transfer""_reader.log" 2>&1 &
+    sleep 0.2 && taskset -c "$cpu_writer" "$program" "sink" "fifo-splice" "writer" "$iterations" "$size" "$transfer" >> "$logs/sink_fifo-splice_$transfer""_writer.log" 2>&1 &
+
+    wait && sleep 1
+  done
+done
+
+echo "Running allocation benchmark"
+
+iterations=100000
+size=128
+
+for handler in "${handlers[@]}"; do
+  echo "> Running $handler with $size Bytes"
+
+  # Only the reader counts allocations, which requires the replaced operator new
+  taskset -c "$cpu_reader" "$program-allocation" "allocation" "$handler" "reader" "$iterations" "$size" >> "$logs/allocation_$handler""_reader.log" 2>&1 &
+  sleep 0.2 && taskset -c "$cpu_writer" "$program" "allocation" "$handler" "writer" "$iterations" "$size" >> "$logs/allocation_$handler""_writer.log" 2>&1 &
+
+  wait && sleep 1
+done
+
 echo "Running execution time benchmark"
 
 iterations=1000
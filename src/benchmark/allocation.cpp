@@ -0,0 +1,123 @@
+#include "benchmark/allocation.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "object/binary_data.hpp"
+#include "utility.hpp"
+
+namespace ipc::benchmark {
+
+/// Amount of heap allocations of this process, only defined if the allocation hook is linked.
+extern std::atomic<std::size_t> allocation_count __attribute__((weak));
+
+AllocationBenchmark::AllocationBenchmark(unsigned int iterations, unsigned int size, bool server)
+        : iterations_(iterations), size_(size), server_(server) {}
+
+bool AllocationBenchmark::is_counting() {
+    return &allocation_count != nullptr;
+}
+
+std::size_t AllocationBenchmark::count_allocations() {
+    return is_counting() ? allocation_count.load(std::memory_order_relaxed) : 0;
+}
+
+bool AllocationBenchmark::run(ICommunicationHandler &handler) {
+    return server_ ? run_server(handler) : run_client(handler);
+}
+
+bool AllocationBenchmark::setup(ICommunicationHandler &handler) {
+    // Only the reader counts, the writer may run without the hook
+    if (server_ && !is_counting()) {
+        fprintf(stderr, "AllocationBenchmark::setup (Allocations are only counted by ipc-allocation)\n");
+        return false;
+    }
+
+    return handler.open();
+}
+
+bool AllocationBenchmark::run_server(ICommunicationHandler &handler) {
+    constexpr auto max_retries = 10 * 1000 / ICommunicationHandler::WAIT_TIME;
+    auto more_data = false;
+    auto start = count_allocations();
+
+    // Storage is reused for every message
+    DataObject obj{};
+
+    while (received_ < iterations_) {
+        // Wait for new messages
+        auto retry = 0;
+        auto timeout = false;
+        while (!more_data && !timeout && !handler.await_data()) {
+            retry++;
+            timeout = received_ > 0 && retry > max_retries;
+        }
+
+        // Writer stopped sending
+        if (timeout)
+            break;
+
+        // Read messages into the same storage
+        const auto result = handler.read_into(obj);
+        more_data = !std::holds_alternative<CommunicationError>(result);
+
+        if (!more_data) {
+            const auto error = std::get<CommunicationError>(result);
+
+            // 'No data available' is not a real error, so ignore it
+            if (error == CommunicationError::NO_DATA_AVAILABLE)
+                continue;
+
+            std::cout << "Error reading data on iteration " << received_
+                      << " (Error: " << static_cast<int>(error) << ')' << std::endl;
+            return false;
+        }
+
+        received_++;
+
+        // Start counting after the warmup
+        if (received_ == WARMUP)
+            start = count_allocations();
+    }
+
+    allocations_ = received_ > WARMUP ? count_allocations() - start : 0;
+
+    // Steady state must not allocate
+    if (allocations_ != 0) {
+        std::cout << "Heap allocations in steady state: " << allocations_ << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool AllocationBenchmark::run_client(ICommunicationHandler &handler) const {
+    // Package size must account size of vector
+    const auto amount = size_ - sizeof(std::uint32_t);
+
+    // Construct dummy data
+    std::vector<std::byte> b{};
+    for (unsigned int i = 0; i < amount; ++i) {
+        b.push_back(static_cast<std::byte>(rand() % 256));
+    }
+    const BinaryData data(b);
+
+    for (unsigned int i = 1; i <= iterations_; ++i) {
+        const auto result = handler.write(data);
+
+        if (!result) {
+            std::cout << "Error writing data on iteration " << i << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void AllocationBenchmark::cleanup(ICommunicationHandler &handler) {
+    handler.close();
+}
+
+}
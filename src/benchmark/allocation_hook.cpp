@@ -0,0 +1,54 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/*
+ * Replacement of the global operator new, which is only linked into the ipc-allocation executable, as counting slows
+ * down every allocation of the other benchmarks. Array and nothrow versions forward to these by default.
+ * Memory allocated with malloc, e.g. by libdbus, is not counted.
+ */
+
+namespace ipc::benchmark {
+
+/// Amount of heap allocations of this process.
+std::atomic<std::size_t> allocation_count{0};
+
+}
+
+void *operator new(std::size_t size) {
+    ipc::benchmark::allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    // Allocate at least one byte, so every call returns a unique pointer
+    if (auto ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    ipc::benchmark::allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+    // Size must be a multiple of the alignment
+    const auto align = static_cast<std::size_t>(alignment);
+    const auto rounded = ((size == 0 ? 1 : size) + align - 1) / align * align;
+    if (auto ptr = std::aligned_alloc(align, rounded))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
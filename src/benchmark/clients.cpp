@@ -0,0 +1,144 @@
+#include "benchmark/clients.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+extern "C" {
+#include <sys/wait.h>
+#include <unistd.h>
+}
+
+#include "object/binary_data.hpp"
+#include "utility.hpp"
+
+namespace ipc::benchmark {
+
+ClientsBenchmark::ClientsBenchmark(unsigned int iterations, unsigned int size, bool server, unsigned int clients)
+        : iterations_(iterations), size_(std::max<unsigned int>(size, 2 * sizeof(std::uint32_t))), server_(server),
+          clients_(std::max(clients, 1u)) {}
+
+bool ClientsBenchmark::run(ICommunicationHandler &handler) {
+    return server_ ? run_server(handler) : run_client(handler);
+}
+
+bool ClientsBenchmark::setup(ICommunicationHandler &handler) {
+    if (server_) {
+        latencies_.resize(clients_);
+        for (auto &latencies: latencies_)
+            latencies.reserve(iterations_);
+    }
+
+    return handler.open();
+}
+
+bool ClientsBenchmark::run_server(ICommunicationHandler &handler) {
+    constexpr auto max_retries = 10 * 1000 / ICommunicationHandler::WAIT_TIME;
+    const auto total = iterations_ * clients_;
+    auto more_data = false;
+
+    while (received_ < total) {
+        // Wait for new messages
+        auto retry = 0;
+        while (!more_data && !handler.await_data()) {
+            retry++;
+
+            if (received_ > 0 && retry > max_retries)
+                return true;
+        }
+
+        // Read messages, only the index of the client is taken from the body
+        const auto result = handler.read_view();
+        more_data = !std::holds_alternative<ipc::CommunicationError>(result);
+
+        if (!more_data) {
+            const auto error = std::get<ipc::CommunicationError>(result);
+
+            // 'No data available' is not a real error, so ignore it
+            if (error == ipc::CommunicationError::NO_DATA_AVAILABLE)
+                continue;
+
+            std::cout << "Error reading data on iteration " << received_
+                      << " (Error: " << static_cast<int>(error) << ')' << std::endl;
+            return false;
+        }
+
+        const auto &[header, view] = std::get<std::tuple<DataHeader, DataObjectView>>(result);
+        const auto now = ipc::get_timestamp();
+
+        std::uint32_t index = clients_;
+        if (const auto binary = std::get_if<BinaryDataView>(&view); binary && binary->size() >= sizeof(index))
+            std::memcpy(&index, binary->data(), sizeof(index));
+
+        if (index >= clients_) {
+            std::cout << "Invalid client on iteration " << received_ << std::endl;
+            return false;
+        }
+
+        // Compute latency from creation to now
+        if (received_ == 0)
+            start_time_ = header.get_timestamp();
+        end_time_ = now;
+        received_++;
+
+        latencies_[index].push_back(now - header.get_timestamp());
+    }
+
+    return true;
+}
+
+bool ClientsBenchmark::run_client(ICommunicationHandler &handler) const {
+    // Fork additional clients, which open their own connection
+    std::vector<pid_t> children{};
+    for (unsigned int c = 1; c < clients_; ++c) {
+        const auto pid = fork();
+        if (pid == -1) {
+            perror("ClientsBenchmark::run_client (fork)");
+            break;
+        }
+
+        if (pid == 0) {
+            handler.close();
+            const auto success = handler.open() && run_writer(handler, c);
+            _exit(success ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        children.push_back(pid);
+    }
+
+    // This process is the first client
+    auto success = run_writer(handler, 0);
+
+    for (const auto pid: children) {
+        int status;
+        if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+            success = false;
+    }
+
+    return success;
+}
+
+bool ClientsBenchmark::run_writer(ICommunicationHandler &handler, std::uint32_t index) const {
+    // Package size must account size of vector, the body starts with the index of the client
+    std::vector<std::byte> b(size_ - sizeof(std::uint32_t));
+    std::memcpy(b.data(), &index, sizeof(index));
+    const BinaryData data(std::move(b));
+
+    for (unsigned int i = 1; i <= iterations_; ++i) {
+        const auto result = handler.write(data);
+
+        if (!result) {
+            std::cout << "Error writing data on iteration " << i << " of client " << index << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ClientsBenchmark::cleanup(ICommunicationHandler &handler) {
+    handler.close();
+}
+
+}
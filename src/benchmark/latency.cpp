@@ -8,8 +8,9 @@
 
 namespace ipc::benchmark {
 
-LatencyBenchmark::LatencyBenchmark(unsigned int iterations, unsigned int delay, bool server)
-        : iterations_(iterations), delay_(delay), server_(server) {}
+LatencyBenchmark::LatencyBenchmark(unsigned int iterations, unsigned int delay, bool server,
+                                   WaitPolicy policy, unsigned int spin_count)
+        : iterations_(iterations), delay_(delay), server_(server), policy_(policy), spin_count_(spin_count) {}
 
 bool LatencyBenchmark::run(ICommunicationHandler &handler) {
     return server_ ? run_server(handler) : run_client(handler);
@@ -17,6 +18,7 @@ bool LatencyBenchmark::run(ICommunicationHandler &handler) {
 
 bool LatencyBenchmark::setup(ICommunicationHandler &handler) {
     latencies_.reserve(iterations_);
+    handler.set_wait_policy(policy_, spin_count_);
     return handler.open();
 }
 
@@ -0,0 +1,160 @@
+#include "benchmark/reactor.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+#include "handler/stream_socket.hpp"
+#include "object/binary_data.hpp"
+#include "utility.hpp"
+
+namespace ipc::benchmark {
+
+ReactorBenchmark::ReactorBenchmark(unsigned int iterations, unsigned int size, bool server, unsigned int reconnect)
+        : iterations_(iterations), size_(size), server_(server), reconnect_(reconnect) {}
+
+bool ReactorBenchmark::run(const std::vector<std::shared_ptr<ICommunicationHandler>> &handlers) {
+    return server_ ? run_server(handlers) : run_client(handlers);
+}
+
+bool ReactorBenchmark::setup(const std::vector<std::shared_ptr<ICommunicationHandler>> &handlers) {
+    for (const auto &handler: handlers) {
+        if (!handler->open())
+            return false;
+    }
+
+    if (!server_)
+        return true;
+
+    // Register every handler at a single reactor
+    if (!reactor_.open())
+        return false;
+
+    for (const auto &handler: handlers) {
+        if (!reactor_.add(*handler)) {
+            fprintf(stderr, "ReactorBenchmark::setup (Handler could not be registered)\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ReactorBenchmark::run_server(const std::vector<std::shared_ptr<ICommunicationHandler>> &handlers) {
+    constexpr auto max_retries = 10 * 1000 / ICommunicationHandler::WAIT_TIME;
+    const auto total = iterations_ * handlers.size();
+
+    while (received_ < total) {
+        // Wait for any handler with new messages
+        auto retry = 0;
+        auto res = 0;
+        while ((res = reactor_.wait(ICommunicationHandler::WAIT_TIME)) == 0) {
+            retry++;
+
+            if (received_ > 0 && retry > max_retries)
+                return true;
+        }
+
+        if (res == -1)
+            return false;
+
+        waits_++;
+
+        // Reported handlers must be read until no data is available
+        for (const auto handler: reactor_.ready()) {
+            if (!drain(*handler))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool ReactorBenchmark::drain(ICommunicationHandler &handler) {
+    while (true) {
+        const auto result = handler.read_view();
+
+        if (std::holds_alternative<CommunicationError>(result)) {
+            const auto error = std::get<CommunicationError>(result);
+
+            // 'No data available' is not a real error, so ignore it
+            if (error == CommunicationError::NO_DATA_AVAILABLE)
+                return true;
+
+            // Accept the reconnected client without blocking the other handlers, otherwise the reactor waits for it
+            if (error == CommunicationError::CONNECTION_CLOSED) {
+                if (const auto s = dynamic_cast<StreamSocket *>(&handler)) {
+                    disconnects_++;
+
+                    const auto policy = s->wait_policy();
+                    const auto spin_count = s->spin_count();
+
+                    s->set_wait_policy(WaitPolicy::POLL);
+                    const auto accepted = s->accept();
+                    s->set_wait_policy(policy, spin_count);
+
+                    if (!accepted)
+                        return true;
+
+                    continue;
+                }
+            }
+
+            std::cout << "Error reading data on iteration " << received_
+                      << " (Error: " << static_cast<int>(error) << ')' << std::endl;
+            return false;
+        }
+
+        if (received_ == 0)
+            start_time_ = std::get<0>(std::get<std::tuple<DataHeader, DataObjectView>>(result)).get_timestamp();
+        end_time_ = get_timestamp();
+        received_++;
+    }
+}
+
+bool ReactorBenchmark::run_client(const std::vector<std::shared_ptr<ICommunicationHandler>> &handlers) const {
+    // Package size must account size of vector
+    const auto amount = size_ - sizeof(std::uint32_t);
+
+    // Construct dummy data
+    std::vector<std::byte> b{};
+    for (unsigned int i = 0; i < amount; ++i) {
+        b.push_back(static_cast<std::byte>(rand() % 256));
+    }
+    const BinaryData data(b);
+
+    for (unsigned int i = 1; i <= iterations_; ++i) {
+        for (const auto &handler: handlers) {
+            if (!handler->write(data)) {
+                std::cout << "Error writing data on iteration " << i << std::endl;
+                return false;
+            }
+        }
+
+        if (reconnect_ == 0 || i % reconnect_ != 0 || i == iterations_)
+            continue;
+
+        // Reconnect stream clients, the server reads the remaining messages of the old connection first
+        for (const auto &handler: handlers) {
+            if (!dynamic_cast<StreamSocket *>(handler.get()))
+                continue;
+
+            handler->close();
+            if (!handler->open()) {
+                std::cout << "Error reconnecting on iteration " << i << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void ReactorBenchmark::cleanup(const std::vector<std::shared_ptr<ICommunicationHandler>> &handlers) {
+    // Stop the bridges before their handlers are closed
+    reactor_.close();
+
+    for (const auto &handler: handlers)
+        handler->close();
+}
+
+}
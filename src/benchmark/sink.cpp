@@ -0,0 +1,149 @@
+#include "benchmark/sink.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+}
+
+#include "handler/fifo.hpp"
+#include "object/binary_data.hpp"
+#include "utility.hpp"
+
+namespace ipc::benchmark {
+
+SinkBenchmark::SinkBenchmark(unsigned int iterations, unsigned int size, bool server, bool splice, std::string path)
+        : iterations_(iterations), size_(size), server_(server), splice_(splice), path_(std::move(path)) {}
+
+bool SinkBenchmark::run(ICommunicationHandler &handler) {
+    return server_ ? run_server(handler) : run_client(handler);
+}
+
+bool SinkBenchmark::setup(ICommunicationHandler &handler) {
+    if (!server_)
+        return handler.open();
+
+    // Only the pipe of a fifo can be spliced
+    if (splice_ && !dynamic_cast<Fifo *>(&handler)) {
+        fprintf(stderr, "SinkBenchmark::setup (Splicing requires a fifo)\n");
+        return false;
+    }
+
+    // Open the sink before the handler, so the writer doesn't start early
+    fd_ = open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ == -1) {
+        perror("SinkBenchmark::setup (open)");
+        return false;
+    }
+
+    return handler.open();
+}
+
+bool SinkBenchmark::run_server(ICommunicationHandler &handler) {
+    constexpr auto max_retries = 10 * 1000 / ICommunicationHandler::WAIT_TIME;
+    auto more_data = false;
+
+    while (received_ < iterations_) {
+        // Wait for new messages
+        auto retry = 0;
+        while (!more_data && !handler.await_data()) {
+            retry++;
+
+            if (received_ > 0 && retry > max_retries)
+                return true;
+        }
+
+        // Move the body of the next message into the sink
+        const auto result = transfer(handler);
+        more_data = !std::holds_alternative<CommunicationError>(result);
+
+        if (!more_data) {
+            const auto error = std::get<CommunicationError>(result);
+
+            // 'No data available' is not a real error, so ignore it
+            if (error == CommunicationError::NO_DATA_AVAILABLE)
+                continue;
+
+            std::cout << "Error reading data on iteration " << received_
+                      << " (Error: " << static_cast<int>(error) << ')' << std::endl;
+            return false;
+        }
+
+        if (received_ == 0)
+            start_time_ = std::get<DataHeader>(result).get_timestamp();
+        end_time_ = get_timestamp();
+        received_++;
+    }
+
+    return true;
+}
+
+std::variant<DataHeader, CommunicationError> SinkBenchmark::transfer(ICommunicationHandler &handler) const {
+    // The pipe moves the body into the sink by itself
+    if (splice_)
+        return static_cast<Fifo &>(handler).read_to(fd_);
+
+    const auto result = handler.read_view();
+    if (std::holds_alternative<CommunicationError>(result))
+        return std::get<CommunicationError>(result);
+
+    // Write the serialized body from the receive buffer, just like the pipe would
+    const auto &[header, view] = std::get<std::tuple<DataHeader, DataObjectView>>(result);
+    std::array<std::byte, sizeof(std::uint32_t)> buffer{};
+    std::array<iovec, ICommunicationHandler::MAX_PARTS> parts{};
+    const auto count = std::visit([&](const auto &obj) {
+        return obj.serialize_parts(buffer.data(), buffer.size(), parts.data(), parts.size());
+    }, view);
+
+    if (count == -1) {
+        fprintf(stderr, "SinkBenchmark::transfer (Invalid object)\n");
+        return CommunicationError::READ_ERROR;
+    }
+
+    if (write_all(fd_, parts.data(), count) == -1) {
+        perror("SinkBenchmark::transfer (write)");
+        return CommunicationError::READ_ERROR;
+    }
+
+    return header;
+}
+
+bool SinkBenchmark::run_client(ICommunicationHandler &handler) const {
+    // Package size must account size of vector
+    const auto amount = size_ - sizeof(std::uint32_t);
+
+    // Construct dummy data
+    std::vector<std::byte> b{};
+    for (unsigned int i = 0; i < amount; ++i) {
+        b.push_back(static_cast<std::byte>(rand() % 256));
+    }
+    const BinaryData data(b);
+
+    for (unsigned int i = 1; i <= iterations_; ++i) {
+        const auto result = handler.write(data);
+
+        if (!result) {
+            std::cout << "Error writing data on iteration " << i << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SinkBenchmark::cleanup(ICommunicationHandler &handler) {
+    handler.close();
+
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+}
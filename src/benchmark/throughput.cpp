@@ -1,22 +1,35 @@
 #include "benchmark/throughput.hpp"
 
+#include <cstdlib>
 #include <iostream>
 #include <thread>
 #include <vector>
 
+extern "C" {
+#include <sys/wait.h>
+#include <unistd.h>
+}
+
 #include "object/binary_data.hpp"
 #include "utility.hpp"
 
 namespace ipc::benchmark {
 
-ThroughputBenchmark::ThroughputBenchmark(unsigned int iterations, unsigned int size, bool server)
-        : iterations_(iterations), size_(size), server_(server) {}
+ThroughputBenchmark::ThroughputBenchmark(unsigned int iterations, unsigned int size, bool server, unsigned int writers,
+                                         unsigned int batch, bool view)
+        : iterations_(iterations), size_(size), server_(server), writers_(writers), batch_(batch), view_(view) {}
 
 bool ThroughputBenchmark::run(ICommunicationHandler &handler) {
     return server_ ? run_server(handler) : run_client(handler);
 }
 
 bool ThroughputBenchmark::setup(ICommunicationHandler &handler) {
+    // The iterations are divided among the writers
+    if (writers_ == 0 || batch_ == 0) {
+        fprintf(stderr, "ThroughputBenchmark::setup (Writers and batch must be at least 1)\n");
+        return false;
+    }
+
     return handler.open();
 }
 
@@ -24,6 +37,10 @@ bool ThroughputBenchmark::run_server(ICommunicationHandler &handler) {
     constexpr auto max_retries = 10 * 1000 / ICommunicationHandler::WAIT_TIME;
     auto more_data = false;
 
+    // Storage for batches is reused for every call
+    std::vector<std::tuple<DataHeader, DataObject>> messages{};
+    messages.reserve(batch_);
+
     while (received_ < iterations_) {
         // Wait for new messages
         auto retry = 0;
@@ -34,34 +51,41 @@ bool ThroughputBenchmark::run_server(ICommunicationHandler &handler) {
                 return true;
         }
 
-        // Read messages
-        const auto result = handler.read();
-        more_data = !std::holds_alternative<ipc::CommunicationError>(result);
+        if (batch_ > 1) {
+            // Read multiple messages at once
+            const auto result = handler.read_batch(messages, batch_);
+            more_data = !std::holds_alternative<ipc::CommunicationError>(result);
 
-        // Handle result
-        const auto success = std::visit(overloaded{
-                [this](const ipc::CommunicationError &error) {
-                    // 'No data available' is not a real error, so ignore it
-                    if (error == ipc::CommunicationError::NO_DATA_AVAILABLE)
-                        return true;
-
-                    std::cout << "Error reading data on iteration " << received_
-                              << " (Error: " << static_cast<int>(error) << ')' << std::endl;
+            if (!more_data) {
+                if (!handle_error(std::get<ipc::CommunicationError>(result)))
                     return false;
-                },
-                [this](const auto &success) {
-                    const DataHeader header = std::get<DataHeader>(success);
 
-                    if (received_ == 1)
-                        start_time_ = header.get_timestamp();
-                    end_time_ = ipc::get_timestamp();
-                    received_++;
+                continue;
+            }
+
+            for (unsigned int i = 0; i < std::get<unsigned int>(result); ++i)
+                receive(std::get<DataHeader>(messages[i]));
+
+            continue;
+        }
+
+        // Handle result of either read
+        const auto handle = [this, &more_data](const auto &result) {
+            more_data = !std::holds_alternative<ipc::CommunicationError>(result);
 
-                    // std::cout << "Data " << received_ << " " << header << std::endl;
+            return std::visit(overloaded{
+                    [this](const ipc::CommunicationError &error) {
+                        return handle_error(error);
+                    },
+                    [this](const auto &success) {
+                        receive(std::get<DataHeader>(success));
+                        return true;
+                    }
+            }, result);
+        };
 
-                    return true;
-                }
-        }, result);
+        // Read messages, views only reference the body in the receive buffer instead of copying it
+        const auto success = view_ ? handle(handler.read_view()) : handle(handler.read());
 
         if (!success)
             return false;
@@ -70,7 +94,57 @@ bool ThroughputBenchmark::run_server(ICommunicationHandler &handler) {
     return true;
 }
 
+void ThroughputBenchmark::receive(const DataHeader &header) {
+    if (received_ == 1)
+        start_time_ = header.get_timestamp();
+    end_time_ = ipc::get_timestamp();
+    received_++;
+
+    // std::cout << "Data " << received_ << " " << header << std::endl;
+}
+
+bool ThroughputBenchmark::handle_error(CommunicationError error) const {
+    // 'No data available' is not a real error, so ignore it
+    if (error == ipc::CommunicationError::NO_DATA_AVAILABLE)
+        return true;
+
+    std::cout << "Error reading data on iteration " << received_
+              << " (Error: " << static_cast<int>(error) << ')' << std::endl;
+    return false;
+}
+
 bool ThroughputBenchmark::run_client(ICommunicationHandler &handler) const {
+    // Fork additional writers, which share the opened handler
+    std::vector<pid_t> children{};
+    for (unsigned int w = 1; w < writers_; ++w) {
+        const auto pid = fork();
+        if (pid == -1) {
+            perror("ThroughputBenchmark::run_client (fork)");
+            break;
+        }
+
+        if (pid == 0) {
+            const auto success = run_writer(handler, iterations_ / writers_);
+            _exit(success ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        children.push_back(pid);
+    }
+
+    // This process writes the remaining messages
+    const auto remaining = iterations_ - children.size() * (iterations_ / writers_);
+    auto success = run_writer(handler, remaining);
+
+    for (const auto pid: children) {
+        int status;
+        if (waitpid(pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+            success = false;
+    }
+
+    return success;
+}
+
+bool ThroughputBenchmark::run_writer(ICommunicationHandler &handler, unsigned int iterations) const {
     // Package size must account size of vector
     const auto amount = size_ - sizeof(std::uint32_t);
 
@@ -81,7 +155,25 @@ bool ThroughputBenchmark::run_client(ICommunicationHandler &handler) const {
     }
     const BinaryData data(b);
 
-    for (unsigned int i = 1; i <= iterations_; ++i) {
+    if (batch_ > 1) {
+        // Write the same message in batches
+        const std::vector<const IDataObject *> objects(batch_, &data);
+        const std::vector<const IDataObject *> rest(iterations % batch_, &data);
+
+        for (unsigned int i = 0; i < iterations; i += batch_) {
+            const auto &batch = i + batch_ <= iterations ? objects : rest;
+            const auto result = handler.write_batch(batch);
+
+            if (result != batch.size()) {
+                std::cout << "Error writing data on iteration " << i + result + 1 << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    for (unsigned int i = 1; i <= iterations; ++i) {
         const auto result = handler.write(data);
 
         if (!result) {
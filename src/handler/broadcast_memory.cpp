@@ -0,0 +1,353 @@
+#include "handler/broadcast_memory.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <csignal>
+#include <utility>
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+#include "utility.hpp"
+
+namespace ipc {
+
+BroadcastMemory::BroadcastMemory(std::string name, bool reader)
+        : name_(std::move(name)), reader_(reader) {}
+
+BroadcastMemory::~BroadcastMemory() {
+    if (fd_ != -1) {
+        BroadcastMemory::close();
+    }
+}
+
+bool BroadcastMemory::open() {
+    // Check if memory is already open
+    if (fd_ != -1)
+        return true;
+
+    // Open or create memory, readers may join before the writer
+    fd_ = shm_open(name_.c_str(), O_RDWR | O_CREAT, 0660);
+    if (fd_ == -1) {
+        perror("BroadcastMemory::open (shm_open)");
+        return false;
+    }
+
+    // Resize memory (keeps the content if it already exists)
+    if (ftruncate(fd_, TOTAL_SIZE) == -1) {
+        perror("BroadcastMemory::open (ftruncate)");
+        close();
+        return false;
+    }
+
+    // Allocate memory
+    auto addr = mmap(nullptr, TOTAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        perror("BroadcastMemory::open (mmap)");
+        close();
+        return false;
+    }
+
+    address_ = static_cast<std::byte *>(addr);
+    control_ = reinterpret_cast<Control *>(address_);
+
+    if (reader_) {
+        if (!register_reader()) {
+            fprintf(stderr, "BroadcastMemory::open (No free reader cursor)\n");
+            close();
+            return false;
+        }
+    } else {
+        // Continue at the current head
+        sequence_ = control_->published.load(std::memory_order_acquire);
+        cached_slowest_ = slowest_reader(true);
+    }
+
+    return true;
+}
+
+bool BroadcastMemory::register_reader() {
+    const auto pid = static_cast<std::int32_t>(getpid());
+
+    for (auto &cursor: control_->cursors) {
+        // Claim the cursor as joining, its sequence is still the one of the previous reader
+        std::int32_t expected = 0;
+        if (!cursor.owner.compare_exchange_strong(expected, -pid, std::memory_order_seq_cst))
+            continue;
+
+        // Late joining readers start at the current head, which must not move while it is stored
+        do {
+            sequence_ = control_->published.load(std::memory_order_seq_cst);
+            cursor.sequence.store(sequence_, std::memory_order_seq_cst);
+        } while (control_->published.load(std::memory_order_seq_cst) != sequence_);
+
+        // Writer may be waiting for this reader to join
+        cursor.owner.store(pid, std::memory_order_seq_cst);
+        if (control_->writer_waiting.exchange(0, std::memory_order_seq_cst))
+            futex_wake(&control_->writer_waiting, 1);
+
+        cached_published_ = sequence_;
+        cursor_ = &cursor;
+        return true;
+    }
+
+    return false;
+}
+
+bool BroadcastMemory::close() {
+    // Check if memory is already closed
+    if (fd_ == -1)
+        return false;
+
+    if (control_ != nullptr) {
+        if (cursor_ != nullptr) {
+            // Unregister reader and let the writer continue without it
+            cursor_->owner.store(0, std::memory_order_seq_cst);
+            if (control_->writer_waiting.exchange(0, std::memory_order_seq_cst))
+                futex_wake(&control_->writer_waiting, 1);
+        }
+
+        munmap(address_, TOTAL_SIZE);
+    }
+
+    address_ = nullptr;
+    control_ = nullptr;
+    cursor_ = nullptr;
+
+    ::close(fd_);
+    fd_ = -1;
+
+    // Only the writer removes the memory, mapped readers keep it alive
+    if (!reader_)
+        shm_unlink(name_.c_str());
+
+    return true;
+}
+
+bool BroadcastMemory::is_open() const {
+    return fd_ != -1;
+}
+
+bool BroadcastMemory::await_data() {
+    // Check if memory is already closed or is writer
+    if (fd_ == -1 || cursor_ == nullptr)
+        return false;
+
+    // Check if data is available without any syscall
+    cached_published_ = control_->published.load(std::memory_order_acquire);
+    if (cached_published_ != sequence_)
+        return true;
+
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return (cached_published_ = control_->published.load(std::memory_order_acquire)) != sequence_; }))
+        return true;
+
+    if (!may_block())
+        return false;
+
+    // Announce sleep and check again, so the writer can't miss it
+    control_->readers_waiting.fetch_add(1, std::memory_order_seq_cst);
+    cached_published_ = control_->published.load(std::memory_order_seq_cst);
+
+    if (cached_published_ == sequence_) {
+        // Wait for data
+        const auto res = futex_wait(&control_->published, sequence_, WAIT_TIME);
+        if (res == -1 && errno != ETIMEDOUT && errno != EAGAIN && errno != EINTR)
+            perror("BroadcastMemory::await_data (futex_wait)");
+
+        cached_published_ = control_->published.load(std::memory_order_acquire);
+    }
+
+    control_->readers_waiting.fetch_sub(1, std::memory_order_relaxed);
+    return cached_published_ != sequence_;
+}
+
+bool BroadcastMemory::has_data() const {
+    // Check if memory is already closed or is writer
+    if (fd_ == -1 || cursor_ == nullptr)
+        return false;
+
+    // Check if data is available
+    return control_->published.load(std::memory_order_acquire) != sequence_;
+}
+
+bool BroadcastMemory::write(const IDataObject &obj) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Split objects which don't fit into a single slot
+    const auto fragments = fragmenter_.split(obj, BUFFER_SIZE - header_size);
+    if (fragments != 0)
+        return fragments != -1 && fragmenter_.write(*this);
+
+    // Reserve slot and serialize body directly into it
+    const auto buffer = reserve(BUFFER_SIZE - header_size);
+    if (buffer == nullptr)
+        return false;
+
+    const auto size = obj.serialize(buffer, BUFFER_SIZE - header_size);
+    if (size == -1) {
+        reserved_ = 0;
+        return false;
+    }
+
+    return commit(obj.get_type(), size);
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> BroadcastMemory::read() {
+    // Continue after a message which is still viewed
+    release_view();
+
+    // Get message directly from the slot, fragments are reassembled on the way
+    const auto message = peek_message();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
+    release();
+
+    if (std::holds_alternative<DataObject>(body)) {
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> BroadcastMemory::read_view() {
+    // Get view directly into the transport, it is released on the next read
+    return peek_view();
+}
+
+std::byte *BroadcastMemory::reserve(unsigned int size) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is already closed, is reader or message is too large
+    if (fd_ == -1 || reader_ || header_size + size > BUFFER_SIZE)
+        return nullptr;
+
+    timestamp_ = get_timestamp();
+
+    // Wait until the slowest reader released the slot
+    while (sequence_ - cached_slowest_ >= TOTAL_AMOUNT) {
+        cached_slowest_ = slowest_reader(false);
+        if (sequence_ - cached_slowest_ < TOTAL_AMOUNT)
+            break;
+
+        // Announce sleep and check again, so the readers can't miss it
+        control_->writer_waiting.store(1, std::memory_order_seq_cst);
+        cached_slowest_ = slowest_reader(false);
+
+        if (sequence_ - cached_slowest_ >= TOTAL_AMOUNT) {
+            const auto res = futex_wait(&control_->writer_waiting, 1, WAIT_TIME);
+            if (res == -1 && errno == ETIMEDOUT) {
+                // Readers may have died without unregistering
+                cached_slowest_ = slowest_reader(true);
+            } else if (res == -1 && errno != EAGAIN && errno != EINTR) {
+                perror("BroadcastMemory::reserve (futex_wait)");
+                control_->writer_waiting.store(0, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+
+        control_->writer_waiting.store(0, std::memory_order_relaxed);
+    }
+
+    reserved_ = size;
+    return &slot(sequence_)[header_size];
+}
+
+bool BroadcastMemory::commit(DataType type, unsigned int size) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is already closed, is reader or size exceeds reservation
+    if (fd_ == -1 || reader_ || size > reserved_)
+        return false;
+
+    last_id_++;
+    DataHeader header(last_id_, type, size, timestamp_);
+
+    // Serialize header in front of the body
+    header.serialize(slot(sequence_), header_size);
+    reserved_ = 0;
+
+    // Publish slot and only wake up readers if any is sleeping
+    sequence_++;
+    control_->published.store(sequence_, std::memory_order_seq_cst);
+    if (control_->readers_waiting.load(std::memory_order_seq_cst) > 0)
+        futex_wake(&control_->published, INT_MAX);
+
+    return true;
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> BroadcastMemory::peek() {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is open
+    if (fd_ == -1 || cursor_ == nullptr)
+        return CommunicationError::CONNECTION_CLOSED;
+
+    // Check if data is available, only touch the writer cache line if required
+    if (cached_published_ == sequence_) {
+        cached_published_ = control_->published.load(std::memory_order_acquire);
+        if (cached_published_ == sequence_)
+            return CommunicationError::NO_DATA_AVAILABLE;
+    }
+
+    // Deserialize header directly from the slot
+    const auto buffer = slot(sequence_);
+    const auto optional = DataHeader::deserialize(buffer, header_size);
+    peeked_ = true;
+
+    if (!optional || optional->get_body_size() > BUFFER_SIZE - header_size) {
+        release();
+        return CommunicationError::INVALID_HEADER;
+    }
+
+    return std::make_tuple(*optional, &buffer[header_size]);
+}
+
+std::uint32_t BroadcastMemory::slowest_reader(bool cleanup) const {
+    const auto published = control_->published.load(std::memory_order_seq_cst);
+    auto lag = 0u;
+
+    for (auto &cursor: control_->cursors) {
+        const auto owner = cursor.owner.load(std::memory_order_seq_cst);
+        if (owner == 0)
+            continue;
+
+        // Remove readers whose process doesn't exist anymore, joining readers store their id negated
+        if (cleanup && kill(owner < 0 ? -owner : owner, 0) == -1 && errno == ESRCH) {
+            auto expected = owner;
+            cursor.owner.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+            continue;
+        }
+
+        // Sequence of a joining reader isn't set yet, so no slot may be overwritten until it joined
+        const auto distance = owner < 0 ? TOTAL_AMOUNT : published - cursor.sequence.load(std::memory_order_seq_cst);
+        if (distance > lag)
+            lag = distance;
+    }
+
+    return published - lag;
+}
+
+void BroadcastMemory::release() {
+    // Check if memory is open and a message was peeked
+    if (fd_ == -1 || cursor_ == nullptr || !peeked_)
+        return;
+
+    peeked_ = false;
+
+    // Move cursor forward and only wake up the writer if it is sleeping
+    sequence_++;
+    cursor_->sequence.store(sequence_, std::memory_order_seq_cst);
+    if (control_->writer_waiting.load(std::memory_order_seq_cst)
+        && control_->writer_waiting.exchange(0, std::memory_order_seq_cst))
+        futex_wake(&control_->writer_waiting, 1);
+}
+
+}
@@ -1,6 +1,8 @@
 #include "handler/datagram_socket.hpp"
 
-#include <cassert>
+#include <algorithm>
+#include <cerrno>
+#include <tuple>
 #include <utility>
 
 extern "C" {
@@ -13,13 +15,17 @@ extern "C" {
 
 namespace ipc {
 
-DatagramSocket::DatagramSocket(std::string path, bool server)
+/// User data of the multishot receive, sends are numbered after it.
+static constexpr std::uint64_t RECEIVE_REQUEST = 1;
+static constexpr std::uint64_t SEND_REQUEST = 2;
+
+DatagramSocket::DatagramSocket(std::string path, bool server, Mode mode)
         : parameters_(std::make_tuple(std::move(path), std::nullopt)),
-          server_(server), unix_(true) {}
+          server_(server), unix_(true), mode_(mode), uring_(mode == Mode::URING) {}
 
-DatagramSocket::DatagramSocket(std::string address, std::uint16_t port, bool server)
+DatagramSocket::DatagramSocket(std::string address, std::uint16_t port, bool server, Mode mode)
         : parameters_(std::make_tuple(std::move(address), port)),
-          server_(server), unix_(false) {}
+          server_(server), unix_(false), mode_(mode), uring_(mode == Mode::URING) {}
 
 DatagramSocket::~DatagramSocket() {
     // Close socket if open
@@ -44,6 +50,14 @@ bool DatagramSocket::open() {
         return false;
     }
 
+    if (uring_) {
+        // Only the server receives, so only it needs buffers for the kernel
+        if (!ring_.open() || (server_ && (!ring_.provide_buffers(RING_BUFFERS, BUFFER_SIZE) || !arm_ring()))) {
+            close();
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -106,6 +120,13 @@ bool DatagramSocket::create_client() {
         // Build addresses for communication
         if (!build_address())
             return false;
+
+        // Connected sockets only report space if the queue of the server isn't full, which the ring waits for
+        const auto address = std::get<0>(address_);
+        if (uring_ && connect(sfd_, reinterpret_cast<const sockaddr *>(&address), sizeof(sockaddr_un)) == -1) {
+            perror("DatagramSocket::create_client (connect)");
+            return false;
+        }
     } else {
         sfd_ = socket(AF_INET, SOCK_DGRAM, 0);
         if (sfd_ == -1) {
@@ -136,6 +157,12 @@ bool DatagramSocket::close() {
 
     sfd_ = -1;
 
+    // Drop queued datagrams, the ring cancels the receive and takes its buffers back
+    received_ = 0;
+    next_ = 0;
+    ring_.close();
+    holding_ = false;
+
     return true;
 }
 
@@ -148,6 +175,33 @@ bool DatagramSocket::await_data() {
     if (sfd_ == -1)
         return false;
 
+    // Datagrams of the last batch are still queued
+    if (next_ < received_)
+        return true;
+
+    if (uring_) {
+        // Completions are checked without any syscall
+        if (spin([this] { return ring_.ready(); }))
+            return true;
+
+        if (!may_block())
+            return false;
+
+        // Block until the next completion arrives
+        const auto res = ring_.wait(WAIT_TIME);
+        if (res == -1)
+            perror("DatagramSocket::await_data (io_uring_enter)");
+
+        return res > 0;
+    }
+
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return poll(sfd_, 0) > 0; }))
+        return true;
+
+    if (!may_block())
+        return false;
+
     // Poll events and block until one is available
     const auto res = poll(sfd_, WAIT_TIME);
     if (res == -1)
@@ -161,6 +215,14 @@ bool DatagramSocket::has_data() const {
     if (sfd_ == -1)
         return false;
 
+    // Datagrams of the last batch are still queued
+    if (next_ < received_)
+        return true;
+
+    // Datagrams are already received by the ring
+    if (uring_)
+        return ring_.ready();
+
     // Poll events and block for 1ms
     const auto res = poll(sfd_, 1);
     if (res == -1)
@@ -169,6 +231,11 @@ bool DatagramSocket::has_data() const {
     return res > 0;
 }
 
+int DatagramSocket::descriptor() const {
+    // Completions of the ring or datagrams on the socket
+    return uring_ ? ring_.descriptor() : sfd_;
+}
+
 bool DatagramSocket::write(const IDataObject &obj) {
     constexpr auto header_size = sizeof(DataHeader);
 
@@ -176,9 +243,20 @@ bool DatagramSocket::write(const IDataObject &obj) {
     if (sfd_ == -1)
         return false;
 
-    // Serialize body
-    const auto size = obj.serialize(&buffer_[header_size], BUFFER_SIZE - header_size);
-    if (size == -1)
+    // Split objects which don't fit into a single datagram
+    const auto fragments = fragmenter_.split(obj, BUFFER_SIZE - header_size);
+    if (fragments != 0)
+        return fragments != -1 && fragmenter_.write(*this);
+
+    // Describe body as parts, only small parts are serialized behind the header
+    std::array<iovec, MAX_PARTS> vectors{};
+    const auto parts = obj.serialize_parts(&buffer_[header_size], BUFFER_SIZE - header_size, &vectors[1], MAX_PARTS - 1);
+    if (parts == -1)
+        return false;
+
+    // Every datagram has to fit into the buffer of the reader
+    const auto size = total_size(&vectors[1], parts);
+    if (size > BUFFER_SIZE - header_size)
         return false;
 
     last_id_++;
@@ -187,54 +265,306 @@ bool DatagramSocket::write(const IDataObject &obj) {
 
     // Serialize header
     header.serialize(buffer_.data(), header_size);
-
-    // Write data into socket
-    ssize_t res;
-    if (unix_) {
-        const auto address = reinterpret_cast<const sockaddr *>(&std::get<0>(address_));
-        res = sendto(sfd_, buffer_.data(), header_size + size, 0, address, sizeof(sockaddr_un));
-    } else {
-        const auto address = reinterpret_cast<const sockaddr *>(&std::get<1>(address_));
-        res = sendto(sfd_, buffer_.data(), header_size + size, 0, address, sizeof(sockaddr_in));
+    vectors[0] = {buffer_.data(), header_size};
+
+    // Write header and body as a single datagram
+    msghdr message{};
+    message.msg_name = unix_ ? static_cast<void *>(&std::get<0>(address_)) : static_cast<void *>(&std::get<1>(address_));
+    message.msg_namelen = unix_ ? sizeof(sockaddr_un) : sizeof(sockaddr_in);
+    message.msg_iov = vectors.data();
+    message.msg_iovlen = parts + 1;
+
+    if (uring_) {
+        mmsghdr ring_message{message, 0};
+        return send_ring(&ring_message, 1) == 1;
     }
 
+    const auto res = sendmsg(sfd_, &message, 0);
     if (res == -1)
-        perror("DatagramSocket::write (sendto)");
+        perror("DatagramSocket::write (sendmsg)");
 
     return res != -1;
 }
 
-std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> DatagramSocket::read() {
+unsigned int DatagramSocket::write_batch(const std::vector<const IDataObject *> &objects) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if socket is open
+    if (sfd_ == -1)
+        return 0;
+
+    // Destination is the same for every datagram
+    auto address = unix_ ? static_cast<void *>(&std::get<0>(address_)) : static_cast<void *>(&std::get<1>(address_));
+    const socklen_t address_size = unix_ ? sizeof(sockaddr_un) : sizeof(sockaddr_in);
+
+    unsigned int written = 0;
+    while (written < objects.size()) {
+        const auto timestamp = get_timestamp();
+
+        // Serialize up to a full batch into separate datagrams
+        unsigned int amount = 0;
+        auto failed = false;
+        auto oversized = false;
+        while (amount < BATCH_SIZE && written + amount < objects.size()) {
+            const auto obj = objects[written + amount];
+            const auto buffer = &send_buffer_[amount * BUFFER_SIZE];
+
+            const auto vectors = &send_vectors_[amount * MAX_PARTS];
+
+            const auto parts = obj->serialize_parts(&buffer[header_size], BUFFER_SIZE - header_size,
+                                                    &vectors[1], MAX_PARTS - 1);
+            if (parts == -1) {
+                failed = true;
+                break;
+            }
+
+            // Objects which don't fit are written as fragments after the batch
+            const auto size = total_size(&vectors[1], parts);
+            if (size > BUFFER_SIZE - header_size) {
+                oversized = true;
+                break;
+            }
+
+            last_id_++;
+            DataHeader header(last_id_, obj->get_type(), size, timestamp);
+            header.serialize(buffer, header_size);
+            vectors[0] = {buffer, header_size};
+
+            send_messages_[amount] = {};
+            send_messages_[amount].msg_hdr.msg_name = address;
+            send_messages_[amount].msg_hdr.msg_namelen = address_size;
+            send_messages_[amount].msg_hdr.msg_iov = vectors;
+            send_messages_[amount].msg_hdr.msg_iovlen = parts + 1;
+            amount++;
+        }
+
+        // Send all datagrams of the batch with a single call
+        unsigned int sent = 0;
+        if (uring_) {
+            sent = send_ring(send_messages_.data(), amount);
+            if (sent < amount)
+                return written + sent;
+        }
+
+        while (sent < amount) {
+            const auto res = sendmmsg(sfd_, &send_messages_[sent], amount - sent, 0);
+            if (res == -1) {
+                if (errno == EINTR)
+                    continue;
+
+                perror("DatagramSocket::write_batch (sendmmsg)");
+                return written + sent;
+            }
+
+            sent += res;
+        }
+
+        written += amount;
+        if (failed || (oversized && !write(*objects[written])))
+            break;
+
+        if (oversized)
+            written++;
+    }
+
+    return written;
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> DatagramSocket::receive() {
     constexpr auto header_size = sizeof(DataHeader);
 
     // Check if socket is open
     if (sfd_ == -1)
         return CommunicationError::CONNECTION_CLOSED;
 
-    // Read data from socket
-    const auto result = recvfrom(sfd_, buffer_.data(), BUFFER_SIZE, 0, nullptr, nullptr);
-    if (result == -1) {
-        if (errno == EAGAIN)
-            return CommunicationError::NO_DATA_AVAILABLE;
+    const std::byte *buffer;
+    std::size_t length;
 
-        perror("DatagramSocket::read (recvfrom)");
-        return CommunicationError::READ_ERROR;
+    if (uring_) {
+        // Take the next datagram received by the ring
+        const auto datagram = receive_ring();
+        if (std::holds_alternative<CommunicationError>(datagram))
+            return std::get<CommunicationError>(datagram);
+
+        std::tie(buffer, length) = std::get<std::tuple<const std::byte *, std::size_t>>(datagram);
+    } else {
+        // Read a batch of datagrams from the socket if the queue is drained
+        if (next_ == received_) {
+            for (unsigned int i = 0; i < BATCH_SIZE; ++i) {
+                receive_vectors_[i] = {&receive_buffer_[i * BUFFER_SIZE], BUFFER_SIZE};
+                receive_messages_[i] = {};
+                receive_messages_[i].msg_hdr.msg_iov = &receive_vectors_[i];
+                receive_messages_[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            const auto result = recvmmsg(sfd_, receive_messages_.data(), BATCH_SIZE, MSG_DONTWAIT, nullptr);
+            if (result == -1) {
+                if (errno == EAGAIN)
+                    return CommunicationError::NO_DATA_AVAILABLE;
+
+                perror("DatagramSocket::receive (recvmmsg)");
+                return CommunicationError::READ_ERROR;
+            }
+
+            received_ = result;
+            next_ = 0;
+        }
+
+        // Take the next datagram from the queue
+        buffer = &receive_buffer_[next_ * BUFFER_SIZE];
+        length = receive_messages_[next_].msg_len;
+        next_++;
     }
 
     // Deserialize header
-    const auto optional = DataHeader::deserialize(buffer_.data(), header_size);
+    const auto optional = DataHeader::deserialize(buffer, length);
     if (!optional)
         return CommunicationError::INVALID_HEADER;
 
     const auto header = *optional;
-    assert(header.get_body_size() == result - header_size);
+    if (header.get_body_size() != length - header_size)
+        return CommunicationError::INVALID_HEADER;
 
-    const auto body = deserialize_data_object(
-            header.get_type(), &buffer_[header_size], header.get_body_size());
+    return std::make_tuple(header, &buffer[header_size]);
+}
+
+std::variant<std::tuple<const std::byte *, std::size_t>, CommunicationError> DatagramSocket::receive_ring() {
+    // Buffer of the previous datagram is not used anymore
+    if (holding_) {
+        ring_.recycle(held_);
+        holding_ = false;
+    }
+
+    const auto next = ring_.peek();
+    if (next == nullptr)
+        return CommunicationError::NO_DATA_AVAILABLE;
+
+    const auto completion = *next;
+    ring_.seen();
+
+    // The kernel stops the receive once it runs out of buffers, so restart it
+    if ((completion.flags & IORING_CQE_F_MORE) == 0 && !arm_ring())
+        return CommunicationError::READ_ERROR;
+
+    if (completion.res < 0) {
+        if (completion.res == -ENOBUFS)
+            return CommunicationError::NO_DATA_AVAILABLE;
+
+        errno = -completion.res;
+        perror("DatagramSocket::receive_ring (recv)");
+        return CommunicationError::READ_ERROR;
+    }
+
+    // A receive, which ended without selecting a buffer, carries no datagram
+    if ((completion.flags & IORING_CQE_F_BUFFER) == 0)
+        return CommunicationError::NO_DATA_AVAILABLE;
+
+    // Keep the buffer until the datagram is consumed
+    held_ = completion.flags;
+    holding_ = true;
+
+    return std::make_tuple(static_cast<const std::byte *>(ring_.provided(completion.flags)),
+                           static_cast<std::size_t>(completion.res));
+}
+
+bool DatagramSocket::arm_ring() {
+    const auto sqe = ring_.prepare(IORING_OP_RECV, sfd_, RECEIVE_REQUEST);
+    if (sqe == nullptr)
+        return false;
+
+    // Every datagram completes separately inside a buffer selected by the kernel
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = 0;
+
+    return ring_.submit() != -1;
+}
+
+unsigned int DatagramSocket::send_ring(mmsghdr *messages, unsigned int amount) {
+    // Datagrams, which still have to be sent
+    std::array<unsigned int, BATCH_SIZE> pending{};
+    unsigned int count = std::min(amount, BATCH_SIZE);
+    for (unsigned int i = 0; i < count; ++i)
+        pending[i] = i;
+
+    unsigned int sent = 0;
+    while (count > 0) {
+        for (unsigned int i = 0; i < count; ++i) {
+            const auto sqe = ring_.prepare(IORING_OP_SENDMSG, sfd_, SEND_REQUEST + pending[i]);
+            if (sqe == nullptr)
+                return sent;
+
+            // Link the sends, so datagrams keep their order, and only send once the server has space
+            sqe->addr = reinterpret_cast<std::uint64_t>(&messages[pending[i]].msg_hdr);
+            sqe->len = 1;
+            sqe->ioprio = IORING_RECVSEND_POLL_FIRST;
+            sqe->flags = i + 1 < count ? IOSQE_IO_LINK : 0;
+        }
+
+        // Submission happens with the first wait
+        unsigned int remaining = 0;
+        auto failed = false;
+        for (unsigned int i = 0; i < count; ++i) {
+            const auto res = ring_.complete(SEND_REQUEST + pending[i]);
+
+            // A failed send breaks the chain, so it is sent again together with the cancelled ones behind it in order
+            if (res == -ECANCELED || res == -EAGAIN || res == -EINTR) {
+                pending[remaining++] = pending[i];
+                continue;
+            }
+
+            // Every datagram carries at least its header, so an empty send is an error as well
+            if (res <= 0) {
+                if (!failed && res == 0) {
+                    fprintf(stderr, "DatagramSocket::send_ring (Empty datagram)\n");
+                } else if (!failed) {
+                    errno = -res;
+                    perror("DatagramSocket::send_ring (sendmsg)");
+                }
+
+                failed = true;
+                continue;
+            }
+
+            sent++;
+        }
+
+        if (failed)
+            break;
+
+        count = remaining;
+    }
+
+    return sent;
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> DatagramSocket::read() {
+    // Receive message into buffer, fragments are reassembled on the way
+    const auto message = reassembler_.receive([this] { return receive(); });
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
 
     if (std::holds_alternative<DataObject>(body)) {
-        const auto obj = std::get<DataObject>(body);
-        return std::make_tuple(header, obj);
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> DatagramSocket::read_view() {
+    // Receive message into buffer, the view is valid until the next read or fragment
+    const auto message = reassembler_.receive([this] { return receive(); });
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    const auto body = deserialize_data_object_view(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObjectView>(body)) {
+        return std::make_tuple(header, std::get<DataObjectView>(body));
     } else {
         return std::get<CommunicationError>(body);
     }
@@ -1,32 +1,43 @@
 #include "handler/dbus.hpp"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <string_view>
 #include <utility>
 
+extern "C" {
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
 #include "utility.hpp"
 
 namespace ipc {
 
-DBus::DBus(std::string name, bool server)
-        : name_(std::move(name)), server_(server) {}
+DBus::DBus(std::string name, bool server, unsigned int options)
+        : name_(std::move(name)), server_(server), memory_files_(options & MEMORY_FILES), peer_(options & PEER),
+          batching_(options & BATCHING) {}
 
 DBus::~DBus() {
-    if (con_ != nullptr) {
+    if (con_ != nullptr || listener_ != nullptr) {
         DBus::close();
     }
 }
 
 bool DBus::open() {
     // Check if dbus is already open
-    if (con_ != nullptr)
+    if (con_ != nullptr || listener_ != nullptr)
         return true;
 
     // Create server or client
     if (server_) {
-        if (!create_server()) {
+        if (peer_ ? !create_peer_server() : !create_server()) {
             close();
             return false;
         }
-    } else if (!create_client()) {
+    } else if (peer_ ? !create_peer_client() : !create_client()) {
         close();
         return false;
     }
@@ -76,11 +87,118 @@ bool DBus::create_client() {
     return true;
 }
 
+bool DBus::create_peer_server() {
+    DBusError err;
+    dbus_error_init(&err);
+
+    // Remove old socket files and listen for the client
+    const auto path = PEER_DIRECTORY + name_;
+    remove(path.c_str());
+
+    listener_ = dbus_server_listen(address().c_str(), &err);
+    if (dbus_error_is_set(&err)) {
+        fprintf(stderr, "Server Error (%s)\n", err.message);
+        dbus_error_free(&err);
+    }
+
+    if (listener_ == nullptr)
+        return false;
+
+    // Without a main loop the listening socket is polled by this handler
+    dbus_server_set_new_connection_function(listener_, add_connection, this, nullptr);
+    if (!dbus_server_set_watch_functions(listener_, add_watch, remove_watch, nullptr, this, nullptr)) {
+        fprintf(stderr, "Out Of Memory!\n");
+        return false;
+    }
+
+    return watch_ != nullptr;
+}
+
+bool DBus::create_peer_client() {
+    DBusError err;
+    dbus_error_init(&err);
+
+    // Connect directly to the server, the connection is not shared with the bus
+    con_ = dbus_connection_open_private(address().c_str(), &err);
+    if (dbus_error_is_set(&err)) {
+        fprintf(stderr, "Connection Error (%s)\n", err.message);
+        dbus_error_free(&err);
+    }
+
+    return con_ != nullptr;
+}
+
+bool DBus::accept(int timeout) {
+    // Check if the client is already connected
+    if (con_ != nullptr)
+        return true;
+
+    if (watch_ == nullptr)
+        return false;
+
+    // Wait for the client, handling the watch accepts it and calls add_connection
+    const auto res = poll(dbus_watch_get_unix_fd(watch_), timeout);
+    if (res == -1)
+        perror("DBus::accept (poll)");
+
+    if (res > 0)
+        dbus_watch_handle(watch_, DBUS_WATCH_READABLE);
+
+    return con_ != nullptr;
+}
+
+void DBus::add_connection(DBusServer *, DBusConnection *connection, void *data) {
+    auto &handler = *static_cast<DBus *>(data);
+
+    // Connections, which are not referenced, are closed by libdbus
+    if (handler.con_ == nullptr)
+        handler.con_ = dbus_connection_ref(connection);
+}
+
+dbus_bool_t DBus::add_watch(DBusWatch *watch, void *data) {
+    // The listening socket is only polled for readability
+    if (dbus_watch_get_flags(watch) & DBUS_WATCH_READABLE)
+        static_cast<DBus *>(data)->watch_ = watch;
+
+    return true;
+}
+
+void DBus::remove_watch(DBusWatch *watch, void *data) {
+    auto &handler = *static_cast<DBus *>(data);
+
+    if (handler.watch_ == watch)
+        handler.watch_ = nullptr;
+}
+
 bool DBus::close() {
     // Check if dbus is already closed
-    if (con_ == nullptr)
+    if (con_ == nullptr && listener_ == nullptr)
         return false;
 
+    // Views into the last message are invalid afterwards
+    release();
+
+    if (peer_) {
+        // Private connections must be closed before they are released
+        if (con_ != nullptr) {
+            dbus_connection_flush(con_);
+            dbus_connection_close(con_);
+            dbus_connection_unref(con_);
+        }
+
+        if (listener_ != nullptr) {
+            dbus_server_disconnect(listener_);
+            dbus_server_unref(listener_);
+            remove((PEER_DIRECTORY + name_).c_str());
+        }
+
+        con_ = nullptr;
+        listener_ = nullptr;
+        watch_ = nullptr;
+
+        return true;
+    }
+
     if (server_) {
         DBusError err;
         dbus_error_init(&err);
@@ -96,21 +214,27 @@ bool DBus::close() {
 }
 
 bool DBus::is_open() const {
-    return con_ != nullptr;
+    return con_ != nullptr || listener_ != nullptr;
 }
 
 bool DBus::await_data() {
-    // Check if dbus is open
-    if (con_ == nullptr)
+    // Check if dbus is open, the peer-to-peer server waits for its client first
+    if (con_ == nullptr && !accept(accept_time()))
         return false;
 
-    // Poll events and block until one is available
-    const auto res = dbus_connection_read_write(con_, WAIT_TIME);
-    if (res == 0)
+    // Entries of the last batch are still pending
+    if (batch_pending())
+        return true;
+
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return read_message(0); }))
+        return true;
+
+    if (!may_block())
         return false;
 
-    const auto status = dbus_connection_get_dispatch_status(con_);
-    return status == DBUS_DISPATCH_DATA_REMAINS;
+    // Poll events and block until a whole message is available
+    return read_message(WAIT_TIME);
 }
 
 bool DBus::has_data() const {
@@ -118,13 +242,43 @@ bool DBus::has_data() const {
     if (con_ == nullptr)
         return false;
 
+    if (batch_pending())
+        return true;
+
     // Poll events and block for 1ms
-    const auto res = dbus_connection_read_write(con_, 1);
-    if (res == 0)
-        return false;
+    return read_message(1);
+}
+
+bool DBus::read_message(int timeout) const {
+    int fd = -1;
+    dbus_connection_get_unix_fd(con_, &fd);
+
+    // Every read only takes a part of large messages, so keep reading until one is complete
+    const auto deadline = get_timestamp() + timeout * 1000000LL;
+    while (dbus_connection_get_dispatch_status(con_) != DBUS_DISPATCH_DATA_REMAINS) {
+        const auto remaining = std::max<std::int64_t>(deadline - get_timestamp(), 0) / 1000000;
+
+        // Reading writes pending data as well, like the replies of the authentication
+        if (!dbus_connection_read_write(con_, static_cast<int>(remaining)))
+            return false;
+
+        // Without time left only parts, which are already readable, are taken
+        if (remaining == 0 && dbus_connection_get_dispatch_status(con_) != DBUS_DISPATCH_DATA_REMAINS
+            && (fd == -1 || poll(fd, 0) <= 0))
+            return false;
+    }
+
+    return true;
+}
+
+int DBus::descriptor() const {
+    // Listening socket of the peer-to-peer server without client
+    if (con_ == nullptr)
+        return watch_ != nullptr ? dbus_watch_get_unix_fd(watch_) : -1;
 
-    const auto status = dbus_connection_get_dispatch_status(con_);
-    return status == DBUS_DISPATCH_DATA_REMAINS;
+    // Messages, which libdbus already read, are only reported by await_data
+    int fd = -1;
+    return dbus_connection_get_unix_fd(con_, &fd) ? fd : -1;
 }
 
 bool DBus::write(const IDataObject &obj) {
@@ -133,7 +287,7 @@ bool DBus::write(const IDataObject &obj) {
         return false;
 
     // Build message object path
-    const auto path = PATH_PREFIX + std::to_string(static_cast<int>(obj.get_type()));
+    const auto &path = object_path(obj.get_type());
     const auto timestamp = get_timestamp();
 
     // Prepare message
@@ -149,13 +303,19 @@ bool DBus::write(const IDataObject &obj) {
     // We don't expect a response
     dbus_message_set_no_reply(msg, true);
 
-    // Serialize body
-    const auto size = obj.serialize(buffer_.data(), BUFFER_SIZE);
-    if (size == -1) {
+    // Describe body as parts to decide how it is transferred
+    std::array<iovec, MAX_PARTS> parts{};
+    const auto count = obj.serialize_parts(buffer_.data(), buffer_.size(), parts.data(), MAX_PARTS);
+    const auto size = count == -1 ? 0 : total_size(parts.data(), count);
+    if (count == -1 || size > MAX_BODY_SIZE) {
         dbus_message_unref(msg);
         return false;
     }
 
+    // Large bodies are passed as memory file, if the connection can pass descriptors
+    const auto memory_file = memory_files_ && size >= MEMORY_FILE_SIZE
+                             && dbus_connection_can_send_type(con_, DBUS_TYPE_UNIX_FD);
+
     last_id_++;
 
     // Prepare arguments
@@ -177,71 +337,297 @@ bool DBus::write(const IDataObject &obj) {
     }
 
     // Append object data
-    DBusMessageIter arr;
-    if (!dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, DBUS_TYPE_BYTE_AS_STRING, &arr)) {
-        fprintf(stderr, "Out Of Memory!\n");
+    const auto appended = memory_file ? append_memory_file(args, parts.data(), count) : append_array(args, obj, size);
+    if (!appended) {
         dbus_message_unref(msg);
         return false;
     }
 
-    const auto ptr = buffer_.data();
-    if (!dbus_message_iter_append_fixed_array(&arr, DBUS_TYPE_BYTE, &ptr, size)) {
+    // Send message
+    if (!dbus_connection_send(con_, msg, nullptr)) {
         fprintf(stderr, "Out Of Memory!\n");
         dbus_message_unref(msg);
         return false;
     }
 
-    if (!dbus_message_iter_close_container(&args, &arr)) {
+    dbus_message_unref(msg);
+    // dbus_connection_flush(con_);
+
+    return true;
+}
+
+unsigned int DBus::write_batch(const std::vector<const IDataObject *> &objects) {
+    // Without batching every object is its own method call
+    if (!batching_)
+        return ICommunicationHandler::write_batch(objects);
+
+    // Check if dbus is open
+    if (con_ == nullptr)
+        return 0;
+
+    unsigned int written = 0;
+    while (written < objects.size()) {
+        const auto packed = write_packed(objects, written);
+        if (packed == 0)
+            break;
+
+        written += packed;
+    }
+
+    return written;
+}
+
+unsigned int DBus::write_packed(const std::vector<const IDataObject *> &objects, std::size_t offset) {
+    // Prepare message, the type of every object is part of its struct
+    const auto msg = dbus_message_new_method_call(
+            name_.c_str(),
+            BATCH_PATH.c_str(),
+            INTERFACE_NAME.c_str(),
+            BATCH_METHOD_NAME.c_str());
+
+    if (msg == nullptr)
+        return 0;
+
+    dbus_message_set_no_reply(msg, true);
+
+    DBusMessageIter args;
+    DBusMessageIter arr;
+    dbus_message_iter_init_append(msg, &args);
+    if (!dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, BATCH_ENTRY_SIGNATURE.c_str(), &arr)) {
         fprintf(stderr, "Out Of Memory!\n");
         dbus_message_unref(msg);
-        return false;
+        return 0;
+    }
+
+    const auto first_id = last_id_;
+    std::size_t packed = 0;
+    std::size_t total = 0;
+
+    for (auto i = offset; i < objects.size(); ++i) {
+        const auto &obj = *objects[i];
+
+        // Describe body as parts to get its size
+        std::array<iovec, MAX_PARTS> parts{};
+        const auto count = obj.serialize_parts(buffer_.data(), buffer_.size(), parts.data(), MAX_PARTS);
+        const auto size = count == -1 ? 0 : total_size(parts.data(), count);
+        if (count == -1 || size > MAX_BODY_SIZE)
+            break;
+
+        // Memory files and objects, which don't fit anymore, start the next message
+        const auto memory_file = memory_files_ && size >= MEMORY_FILE_SIZE
+                                 && dbus_connection_can_send_type(con_, DBUS_TYPE_UNIX_FD);
+        if (packed > 0 && (memory_file || total + size > MAX_BATCH_SIZE))
+            break;
+
+        if (memory_file) {
+            dbus_message_iter_abandon_container(&args, &arr);
+            dbus_message_unref(msg);
+            return write(obj) ? 1 : 0;
+        }
+
+        // Append struct of id, type, timestamp and body
+        last_id_++;
+        const auto type = static_cast<std::uint16_t>(obj.get_type());
+        const auto timestamp = get_timestamp();
+
+        DBusMessageIter entry;
+        if (!dbus_message_iter_open_container(&arr, DBUS_TYPE_STRUCT, nullptr, &entry)
+            || !dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT32, &last_id_)
+            || !dbus_message_iter_append_basic(&entry, DBUS_TYPE_UINT16, &type)
+            || !dbus_message_iter_append_basic(&entry, DBUS_TYPE_INT64, &timestamp)
+            || !append_array(entry, obj, size)
+            || !dbus_message_iter_close_container(&arr, &entry)) {
+            fprintf(stderr, "Out Of Memory!\n");
+            dbus_message_iter_abandon_container(&args, &arr);
+            dbus_message_unref(msg);
+            last_id_ = first_id;
+            return 0;
+        }
+
+        packed++;
+        total += size;
+    }
+
+    // Nothing is sent, if the first object couldn't be serialized
+    if (packed == 0) {
+        dbus_message_iter_abandon_container(&args, &arr);
+        dbus_message_unref(msg);
+        return 0;
     }
 
     // Send message
-    if (!dbus_connection_send(con_, msg, nullptr)) {
+    if (!dbus_message_iter_close_container(&args, &arr) || !dbus_connection_send(con_, msg, nullptr)) {
         fprintf(stderr, "Out Of Memory!\n");
         dbus_message_unref(msg);
-        return false;
+        last_id_ = first_id;
+        return 0;
     }
 
     dbus_message_unref(msg);
-    // dbus_connection_flush(con_);
+    return packed;
+}
+
+const std::string &DBus::object_path(DataType type) {
+    // Paths of all types are built once, unknown types share the path of the invalid type
+    static const auto paths = [] {
+        std::array<std::string, static_cast<std::size_t>(DataType::MEMORY_FILE) + 1> result{};
+        for (std::size_t i = 0; i < result.size(); ++i)
+            result[i] = PATH_PREFIX + std::to_string(i);
+
+        return result;
+    }();
+
+    const auto index = static_cast<std::size_t>(type);
+    return paths[index < paths.size() ? index : 0];
+}
+
+bool DBus::append_array(DBusMessageIter &args, const IDataObject &obj, std::size_t size) {
+    // Serialize body, the buffer grows once for large objects as byte arrays have no small limit
+    if (size > buffer_.size())
+        buffer_.resize(size);
+
+    const auto res = obj.serialize(buffer_.data(), buffer_.size());
+    if (res == -1)
+        return false;
+
+    DBusMessageIter arr;
+    if (!dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, DBUS_TYPE_BYTE_AS_STRING, &arr)) {
+        fprintf(stderr, "Out Of Memory!\n");
+        return false;
+    }
+
+    const auto ptr = buffer_.data();
+    if (!dbus_message_iter_append_fixed_array(&arr, DBUS_TYPE_BYTE, &ptr, res)) {
+        fprintf(stderr, "Out Of Memory!\n");
+        dbus_message_iter_abandon_container(&args, &arr);
+        return false;
+    }
+
+    if (!dbus_message_iter_close_container(&args, &arr)) {
+        fprintf(stderr, "Out Of Memory!\n");
+        return false;
+    }
 
     return true;
 }
 
+bool DBus::append_memory_file(DBusMessageIter &args, iovec *parts, int count) {
+    // Write body into a sealed memory file
+    const auto fd = create_sealed_memory(parts, count);
+    if (fd == -1) {
+        perror("DBus::append_memory_file (memfd_create)");
+        return false;
+    }
+
+    // The message holds its own duplicate of the descriptor
+    const auto res = dbus_message_iter_append_basic(&args, DBUS_TYPE_UNIX_FD, &fd);
+    ::close(fd);
+
+    if (!res)
+        fprintf(stderr, "Out Of Memory!\n");
+
+    return res;
+}
+
 std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> DBus::read() {
+    const auto message = receive();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    // Object is copied out, so the message may be released afterward
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObject>(body)) {
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> DBus::read_view() {
+    // The view points into the message, which is kept until the next read
+    const auto message = receive();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    const auto body = deserialize_data_object_view(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObjectView>(body)) {
+        return std::make_tuple(header, std::get<DataObjectView>(body));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> DBus::receive() {
     // Check if dbus is open
     if (con_ == nullptr)
         return CommunicationError::CONNECTION_CLOSED;
 
+    // Continue with the next entry of the current batch
+    if (batch_ && dbus_message_iter_next(&entries_))
+        return receive_entry();
+
     // Read and remove message from dbus
-    const auto msg = dbus_connection_pop_message(con_);
-    if (msg == nullptr)
+    release();
+    message_ = dbus_connection_pop_message(con_);
+    if (message_ == nullptr)
         return CommunicationError::NO_DATA_AVAILABLE;
 
+    // Prepare read arguments
+    DBusMessageIter args;
+    const auto has_args = dbus_message_iter_init(message_, &args);
+
+    // Batches are an array of structs, which are received one by one
+    if (dbus_message_is_method_call(message_, INTERFACE_NAME.c_str(), BATCH_METHOD_NAME.c_str())) {
+        if (!has_args || dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY
+            || dbus_message_iter_get_element_type(&args) != DBUS_TYPE_STRUCT) {
+            fprintf(stderr, "Argument is not an array of structs!\n");
+            release();
+            return CommunicationError::INVALID_DATA;
+        }
+
+        dbus_message_iter_recurse(&args, &entries_);
+        if (dbus_message_iter_get_arg_type(&entries_) != DBUS_TYPE_STRUCT) {
+            release();
+            return CommunicationError::NO_DATA_AVAILABLE;
+        }
+
+        batch_ = true;
+        return receive_entry();
+    }
+
     // Check for correct type, ignore other
-    if (!dbus_message_is_method_call(msg, INTERFACE_NAME.c_str(), METHOD_NAME.c_str())) {
-        dbus_message_unref(msg);
+    if (!dbus_message_is_method_call(message_, INTERFACE_NAME.c_str(), METHOD_NAME.c_str())) {
+        release();
         return CommunicationError::NO_DATA_AVAILABLE;
     }
 
-    // Prepare read arguments
-    DBusMessageIter args;
-    if (!dbus_message_iter_init(msg, &args)) {
+    if (!has_args) {
         fprintf(stderr, "Message has no arguments!\n");
-        dbus_message_unref(msg);
+        release();
         return CommunicationError::INVALID_DATA;
     }
 
-    // Get object type
-    const auto path = &dbus_message_get_path(msg)[PATH_PREFIX.size()];
-    const auto type = static_cast<DataType>(std::stoul(path, nullptr));
+    // Get object type from the path without allocating
+    const std::string_view path = dbus_message_get_path(message_);
+    std::uint16_t value = 0;
+    const auto begin = path.data() + PATH_PREFIX.size();
+    const auto end = path.data() + path.size();
+    if (path.size() <= PATH_PREFIX.size() || path.compare(0, PATH_PREFIX.size(), PATH_PREFIX) != 0
+        || std::from_chars(begin, end, value).ptr != end) {
+        fprintf(stderr, "Invalid object path!\n");
+        release();
+        return CommunicationError::INVALID_DATA;
+    }
+    const auto type = static_cast<DataType>(value);
 
     // Read id
     if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_UINT32) {
         fprintf(stderr, "Argument is not an uint32!\n");
-        dbus_message_unref(msg);
+        release();
         return CommunicationError::INVALID_DATA;
     }
 
@@ -251,18 +637,35 @@ std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> DBus::read(
     // Read timestamp
     if (!dbus_message_iter_next(&args) || dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_INT64) {
         fprintf(stderr, "Argument is not an int64!\n");
-        dbus_message_unref(msg);
+        release();
         return CommunicationError::INVALID_DATA;
     }
 
     std::int64_t timestamp;
     dbus_message_iter_get_basic(&args, &timestamp);
 
-    // Read object data
-    if (!dbus_message_iter_next(&args) || dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY
+    // Read object data, which is either a byte array or a memory file
+    if (!dbus_message_iter_next(&args)) {
+        fprintf(stderr, "Message has no object data!\n");
+        release();
+        return CommunicationError::INVALID_DATA;
+    }
+
+    if (dbus_message_iter_get_arg_type(&args) == DBUS_TYPE_UNIX_FD) {
+        const auto mapping = map_memory_file(args);
+        if (std::holds_alternative<CommunicationError>(mapping)) {
+            release();
+            return std::get<CommunicationError>(mapping);
+        }
+
+        const auto [data, size] = std::get<std::tuple<const std::byte *, std::size_t>>(mapping);
+        return std::make_tuple(DataHeader(id, type, size, timestamp), data);
+    }
+
+    if (dbus_message_iter_get_arg_type(&args) != DBUS_TYPE_ARRAY
         || dbus_message_iter_get_element_type(&args) != DBUS_TYPE_BYTE) {
         fprintf(stderr, "Argument is not an byte array!\n");
-        dbus_message_unref(msg);
+        release();
         return CommunicationError::INVALID_DATA;
     }
 
@@ -274,16 +677,95 @@ std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> DBus::read(
     dbus_message_iter_recurse(&args, &arr);
     dbus_message_iter_get_fixed_array(&arr, &ptr, &size);
 
-    const auto body = deserialize_data_object(type, ptr, size);
-    dbus_message_unref(msg);
+    return std::make_tuple(DataHeader(id, type, size, timestamp), ptr);
+}
 
-    if (std::holds_alternative<DataObject>(body)) {
-        const auto header = DataHeader(id, type, size, timestamp);
-        const auto obj = std::get<DataObject>(body);
-        return std::make_tuple(header, obj);
-    } else {
-        return std::get<CommunicationError>(body);
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> DBus::receive_entry() {
+    // The signature was checked by libdbus, so only the struct itself is verified
+    DBusMessageIter entry;
+    dbus_message_iter_recurse(&entries_, &entry);
+
+    std::uint32_t id;
+    std::uint16_t type;
+    std::int64_t timestamp;
+    const std::array<int, 3> types{DBUS_TYPE_UINT32, DBUS_TYPE_UINT16, DBUS_TYPE_INT64};
+    void *const values[] = {&id, &type, &timestamp};
+
+    for (std::size_t i = 0; i < types.size(); ++i) {
+        if (dbus_message_iter_get_arg_type(&entry) != types[i]) {
+            fprintf(stderr, "Invalid batch entry!\n");
+            return CommunicationError::INVALID_DATA;
+        }
+
+        dbus_message_iter_get_basic(&entry, values[i]);
+        dbus_message_iter_next(&entry);
     }
+
+    if (dbus_message_iter_get_arg_type(&entry) != DBUS_TYPE_ARRAY
+        || dbus_message_iter_get_element_type(&entry) != DBUS_TYPE_BYTE) {
+        fprintf(stderr, "Argument is not an byte array!\n");
+        return CommunicationError::INVALID_DATA;
+    }
+
+    int size;
+    std::byte *ptr;
+
+    DBusMessageIter arr;
+    dbus_message_iter_recurse(&entry, &arr);
+    dbus_message_iter_get_fixed_array(&arr, &ptr, &size);
+
+    return std::make_tuple(DataHeader(id, static_cast<DataType>(type), size, timestamp), ptr);
+}
+
+std::variant<std::tuple<const std::byte *, std::size_t>, CommunicationError> DBus::map_memory_file(
+        DBusMessageIter &args) {
+    // The descriptor is a duplicate owned by us
+    int fd;
+    dbus_message_iter_get_basic(&args, &fd);
+
+    // The whole sealed file is the body
+    struct stat info{};
+    if (fstat(fd, &info) == -1 || static_cast<std::size_t>(info.st_size) > MAX_BODY_SIZE) {
+        ::close(fd);
+        return CommunicationError::INVALID_DATA;
+    }
+
+    const auto size = static_cast<std::size_t>(info.st_size);
+    const auto data = map_sealed_memory(fd, size);
+    ::close(fd);
+
+    if (data == nullptr) {
+        fprintf(stderr, "Invalid memory file!\n");
+        return CommunicationError::INVALID_DATA;
+    }
+
+    // Mapping is kept until the next receive, so views stay valid
+    mapping_ = data;
+    mapping_size_ = size;
+
+    return std::make_tuple(data, size);
+}
+
+void DBus::release() {
+    if (mapping_ != nullptr)
+        munmap(const_cast<std::byte *>(mapping_), mapping_size_);
+
+    if (message_ != nullptr)
+        dbus_message_unref(message_);
+
+    message_ = nullptr;
+    batch_ = false;
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+}
+
+bool DBus::batch_pending() const {
+    if (!batch_)
+        return false;
+
+    // Iterators are plain values, so a copy looks ahead without moving the batch
+    auto entries = entries_;
+    return dbus_message_iter_has_next(&entries);
 }
 
 }
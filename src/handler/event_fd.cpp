@@ -0,0 +1,392 @@
+#include "handler/event_fd.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <utility>
+
+extern "C" {
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include "utility.hpp"
+
+namespace ipc {
+
+EventFd::EventFd(std::string path, bool server)
+        : path_(std::move(path)), server_(server) {}
+
+EventFd::~EventFd() {
+    // Close eventfd if open
+    if (efd_ != -1) {
+        EventFd::close();
+    }
+}
+
+bool EventFd::open() {
+    // Check if eventfd is already open
+    if (efd_ != -1)
+        return true;
+
+    // Build address for passing the eventfd
+    address_ = {};
+    address_.sun_family = AF_UNIX;
+    strncpy(address_.sun_path, path_.c_str(), sizeof(address_.sun_path) - 1);
+
+    // Create server or client
+    if (server_ ? !create_server() : !create_client()) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool EventFd::create_server() {
+    // Create counter, reads take the whole value at once
+    efd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (efd_ == -1) {
+        perror("EventFd::create_server (eventfd)");
+        return false;
+    }
+
+    // Create memory for the timestamp, which is passed together with the counter
+    mfd_ = memfd_create("ipc-doorbell", MFD_CLOEXEC);
+    if (mfd_ == -1) {
+        perror("EventFd::create_server (memfd_create)");
+        return false;
+    }
+
+    if (ftruncate(mfd_, sizeof(Control)) == -1) {
+        perror("EventFd::create_server (ftruncate)");
+        return false;
+    }
+
+    auto memory = mmap(nullptr, sizeof(Control), PROT_READ | PROT_WRITE, MAP_SHARED, mfd_, 0);
+    if (memory == MAP_FAILED) {
+        perror("EventFd::create_server (mmap)");
+        return false;
+    }
+    control_ = new(memory) Control{};
+
+    // Open socket and remove old socket files
+    sfd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sfd_ == -1) {
+        perror("EventFd::create_server (socket)");
+        return false;
+    }
+    remove(address_.sun_path);
+
+    // Bind socket for listing
+    if (bind(sfd_, reinterpret_cast<const sockaddr *>(&address_), sizeof(sockaddr_un)) == -1) {
+        perror("EventFd::create_server (bind)");
+        return false;
+    }
+
+    // Listen for incoming socket connections
+    if (listen(sfd_, BACKLOG) == -1) {
+        perror("EventFd::create_server (listen)");
+        return false;
+    }
+
+    // Wait on counter and writers at once, so new writers are served while waiting for pings
+    pfd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (pfd_ == -1) {
+        perror("EventFd::create_server (epoll_create1)");
+        return false;
+    }
+
+    for (const auto fd: {efd_, sfd_}) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(pfd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+            perror("EventFd::create_server (epoll_ctl)");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool EventFd::create_client() {
+    // Open socket
+    const auto fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        perror("EventFd::create_client (socket)");
+        return false;
+    }
+
+    // Connect to server and wait until it passes the descriptors
+    const timeval timeout{WAIT_TIME / 1000, (WAIT_TIME % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    if (connect(fd, reinterpret_cast<const sockaddr *>(&address_), sizeof(sockaddr_un)) == -1) {
+        perror("EventFd::create_client (connect)");
+        ::close(fd);
+        return false;
+    }
+
+    std::byte data{};
+    iovec vector{&data, sizeof(data)};
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(2 * sizeof(int))> control{};
+    msghdr message{};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    ssize_t res;
+    do {
+        res = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+    } while (res == -1 && errno == EINTR);
+    ::close(fd);
+
+    const auto cmsg = CMSG_FIRSTHDR(&message);
+    if (res == -1 || cmsg == nullptr || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(2 * sizeof(int))) {
+        if (res == -1)
+            perror("EventFd::create_client (recvmsg)");
+        else
+            fprintf(stderr, "EventFd::create_client (Missing descriptors)\n");
+
+        return false;
+    }
+
+    std::memcpy(&efd_, CMSG_DATA(cmsg), sizeof(int));
+    std::memcpy(&mfd_, CMSG_DATA(cmsg) + sizeof(int), sizeof(int));
+
+    // Map the timestamp, the memory file isn't needed afterwards
+    auto memory = mmap(nullptr, sizeof(Control), PROT_READ | PROT_WRITE, MAP_SHARED, mfd_, 0);
+    ::close(mfd_);
+    mfd_ = -1;
+
+    if (memory == MAP_FAILED) {
+        perror("EventFd::create_client (mmap)");
+        return false;
+    }
+    control_ = static_cast<Control *>(memory);
+
+    return true;
+}
+
+bool EventFd::close() {
+    // Check if eventfd is already closed
+    if (efd_ == -1 && sfd_ == -1)
+        return false;
+
+    if (control_ != nullptr)
+        munmap(control_, sizeof(Control));
+
+    // Close all descriptors
+    for (const auto fd: {efd_, sfd_, pfd_, mfd_}) {
+        if (fd != -1)
+            ::close(fd);
+    }
+
+    // Remove file only for the server
+    if (server_ && sfd_ != -1)
+        remove(address_.sun_path);
+
+    efd_ = -1;
+    sfd_ = -1;
+    pfd_ = -1;
+    mfd_ = -1;
+    control_ = nullptr;
+    pending_ = 0;
+
+    return true;
+}
+
+bool EventFd::is_open() const {
+    return efd_ != -1;
+}
+
+void EventFd::serve() {
+    // Both descriptors are passed with a single byte
+    const std::array<int, 2> fds{efd_, mfd_};
+    std::byte data{};
+    iovec vector{&data, sizeof(data)};
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(fds))> control{};
+
+    while (true) {
+        const auto cfd = ::accept4(sfd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (cfd == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                perror("EventFd::serve (accept)");
+
+            return;
+        }
+
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        const auto cmsg = CMSG_FIRSTHDR(&message);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+        std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(fds));
+
+        // The writer holds its own references afterwards, so the connection is closed right away
+        if (sendmsg(cfd, &message, MSG_NOSIGNAL) == -1)
+            perror("EventFd::serve (sendmsg)");
+        ::close(cfd);
+    }
+}
+
+bool EventFd::await_data() {
+    // Check if eventfd is open and is reader
+    if (pfd_ == -1)
+        return false;
+
+    // Pings of the last counter are still pending
+    if (pending_ > 0)
+        return true;
+
+    // Spin before blocking depending on the wait policy
+    const auto ready = spin([this] { return poll(pfd_, 0) > 0; });
+    if (!ready && !may_block())
+        return false;
+
+    // Take the events, which are already there if spinning succeeded
+    const auto res = epoll_wait(pfd_, events_.data(), events_.size(), ready ? 0 : WAIT_TIME);
+    if (res == -1) {
+        if (errno != EINTR)
+            perror("EventFd::await_data (epoll_wait)");
+
+        return false;
+    }
+
+    auto available = false;
+    for (int i = 0; i < res; ++i) {
+        if (events_[i].data.fd == sfd_)
+            serve();
+        else
+            available = true;
+    }
+
+    return available;
+}
+
+bool EventFd::has_data() const {
+    // Check if eventfd is open and is reader
+    if (pfd_ == -1)
+        return false;
+
+    if (pending_ > 0)
+        return true;
+
+    // Poll events and block for 1ms
+    const auto res = poll(efd_, 1);
+    if (res == -1)
+        perror("EventFd::has_data (poll)");
+
+    return res > 0;
+}
+
+int EventFd::descriptor() const {
+    // Epoll of counter and socket, so the reader wakes for new writers as well
+    return pfd_;
+}
+
+bool EventFd::notify(std::uint64_t count) {
+    // Check if eventfd is open
+    if (efd_ == -1 || count == 0)
+        return false;
+
+    // Publish the timestamp before the reader can take the counter
+    control_->timestamp.store(get_timestamp(), std::memory_order_release);
+
+    ssize_t res;
+    do {
+        res = ::write(efd_, &count, sizeof(count));
+    } while (res == -1 && errno == EINTR);
+
+    if (res == -1)
+        perror("EventFd::notify (write)");
+
+    return res != -1;
+}
+
+bool EventFd::write(const IDataObject &obj) {
+    // Only pings fit into the counter
+    if (obj.get_type() != DataType::PING) {
+        fprintf(stderr, "EventFd::write (Only pings are supported)\n");
+        return false;
+    }
+
+    return notify(1);
+}
+
+unsigned int EventFd::write_batch(const std::vector<const IDataObject *> &objects) {
+    // Only pings fit into the counter
+    for (const auto obj: objects) {
+        if (obj->get_type() != DataType::PING) {
+            fprintf(stderr, "EventFd::write_batch (Only pings are supported)\n");
+            return 0;
+        }
+    }
+
+    return notify(objects.size()) ? objects.size() : 0;
+}
+
+std::optional<CommunicationError> EventFd::receive() {
+    // Check if eventfd is open and is reader
+    if (pfd_ == -1)
+        return CommunicationError::CONNECTION_CLOSED;
+
+    if (pending_ > 0)
+        return std::nullopt;
+
+    // Take the whole counter, which resets it to zero
+    std::uint64_t count;
+    const auto res = ::read(efd_, &count, sizeof(count));
+    if (res == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return CommunicationError::NO_DATA_AVAILABLE;
+
+        perror("EventFd::receive (read)");
+        return CommunicationError::READ_ERROR;
+    }
+
+    pending_ = count;
+    timestamp_ = control_->timestamp.load(std::memory_order_acquire);
+
+    return std::nullopt;
+}
+
+std::uint64_t EventFd::take() {
+    if (receive())
+        return 0;
+
+    // Pings are dropped, only the counter matters
+    const auto count = pending_;
+    pending_ = 0;
+    return count;
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> EventFd::read() {
+    if (const auto error = receive())
+        return *error;
+
+    pending_--;
+    last_id_++;
+    return std::make_tuple(DataHeader(last_id_, DataType::PING, 0, timestamp_), Ping());
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> EventFd::read_view() {
+    if (const auto error = receive())
+        return *error;
+
+    pending_--;
+    last_id_++;
+    return std::make_tuple(DataHeader(last_id_, DataType::PING, 0, timestamp_), DataObjectView(Ping()));
+}
+
+}
@@ -1,11 +1,15 @@
 #include "handler/fifo.hpp"
 
-#include <cassert>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
 #include <utility>
 
 extern "C" {
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 }
 
@@ -13,8 +17,12 @@ extern "C" {
 
 namespace ipc {
 
-Fifo::Fifo(std::string path, bool readonly)
-        : path_(std::move(path)), readonly_(readonly) {}
+/// User data of the read in flight.
+static constexpr std::uint64_t READ_REQUEST = 1;
+
+Fifo::Fifo(std::string path, bool readonly, Mode mode)
+        : path_(std::move(path)), readonly_(readonly), mode_(mode), uring_(mode == Mode::URING),
+          splice_(mode == Mode::SPLICE), packet_(mode == Mode::PACKET) {}
 
 Fifo::~Fifo() {
     // Close pipe if open
@@ -39,8 +47,8 @@ bool Fifo::open() {
         }
     }
 
-    // Open pipe
-    const auto flag = readonly_ ? O_RDWR | O_NONBLOCK : O_RDWR;
+    // Open pipe, the ring waits for data itself and would fail non-blocking reads instead
+    const auto flag = readonly_ && !uring_ ? O_RDWR | O_NONBLOCK : O_RDWR;
     fd_ = ::open(path_.c_str(), flag);
     if (fd_ == -1) {
         perror("Fifo::open (open)");
@@ -50,6 +58,44 @@ bool Fifo::open() {
         return false;
     }
 
+    // Larger pipes take more spliced pages or packets before the writer blocks, as every packet takes a whole page.
+    // The default capacity is kept on failure
+    if ((splice_ || packet_) && fcntl(fd_, F_SETPIPE_SZ, PIPE_SIZE) == -1)
+        perror("Fifo::open (fcntl)");
+
+    if (packet_ && readonly_) {
+        // Packets are truncated to the size of a read, so the buffer always has room for a whole one
+        receive_buffer_.resize(std::max(receive_buffer_.size(), PACKET_BUFFER_SIZE));
+    } else if (packet_) {
+        // Packets are made by the writer, so only its file is switched to them
+        flags_ = fcntl(fd_, F_GETFL);
+        if (flags_ == -1 || fcntl(fd_, F_SETFL, flags_ | O_DIRECT) == -1) {
+            perror("Fifo::open (fcntl)");
+            flags_ = -1;
+        } else {
+            direct_ = true;
+        }
+    }
+
+    if (uring_) {
+        if (!ring_.open()) {
+            close();
+            return false;
+        }
+
+        // The reader keeps a read into its registered buffer in flight
+        if (readonly_) {
+            receive_buffer_.resize(std::max(receive_buffer_.size(), RING_BUFFER_SIZE));
+            const iovec buffer{receive_buffer_.data(), receive_buffer_.size()};
+            fixed_ = ring_.register_buffers(&buffer, 1);
+
+            if (!arm_ring()) {
+                close();
+                return false;
+            }
+        }
+    }
+
     return true;
 }
 
@@ -58,6 +104,14 @@ bool Fifo::close() {
     if (fd_ == -1)
         return false;
 
+    // Close ring first, which cancels the read in flight
+    ring_.close();
+    begin_ = end_ = 0;
+    reading_ = false;
+    fixed_ = false;
+    flags_ = -1;
+    direct_ = false;
+
     // Close and unlink pipe
     ::close(fd_);
 
@@ -77,6 +131,40 @@ bool Fifo::await_data() {
     if (fd_ == -1)
         return false;
 
+    if (uring_) {
+        // Complete frames are already buffered
+        if (buffered())
+            return true;
+
+        if (!arm_ring())
+            return false;
+
+        // Completions are checked without any syscall
+        if (spin([this] { return ring_.ready(); }))
+            return true;
+
+        if (!may_block())
+            return false;
+
+        // Block until the read completes
+        const auto res = ring_.wait(WAIT_TIME);
+        if (res == -1)
+            perror("Fifo::await_data (io_uring_enter)");
+
+        return res > 0;
+    }
+
+    // Complete frames are already buffered
+    if (packet_ && buffered())
+        return true;
+
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return poll(fd_, 0) > 0; }))
+        return true;
+
+    if (!may_block())
+        return false;
+
     // Poll events and block until one is available
     const auto res = poll(fd_, WAIT_TIME);
     if (res == -1)
@@ -90,6 +178,13 @@ bool Fifo::has_data() const {
     if (fd_ == -1)
         return false;
 
+    // Data is already read by the ring
+    if (uring_)
+        return buffered() || ring_.ready();
+
+    if (packet_ && buffered())
+        return true;
+
     // Poll events and block for 1ms
     const auto res = poll(fd_, 1);
     if (res == -1)
@@ -98,6 +193,11 @@ bool Fifo::has_data() const {
     return res > 0;
 }
 
+int Fifo::descriptor() const {
+    // Completions of the ring or data in the pipe
+    return uring_ ? ring_.descriptor() : fd_;
+}
+
 bool Fifo::write(const IDataObject &obj) {
     constexpr auto header_size = sizeof(DataHeader);
 
@@ -105,10 +205,15 @@ bool Fifo::write(const IDataObject &obj) {
     if (fd_ == -1)
         return false;
 
-    // Serialize body
+    // Describe body as parts, only small parts are serialized behind the header
     const auto timestamp = get_timestamp();
-    const auto size = obj.serialize(&buffer_[header_size], BUFFER_SIZE - header_size);
-    if (size == -1)
+    std::array<iovec, MAX_PARTS> vectors{};
+    const auto parts = obj.serialize_parts(&buffer_[header_size], BUFFER_SIZE - header_size, &vectors[1], MAX_PARTS - 1);
+    if (parts == -1)
+        return false;
+
+    const auto size = total_size(&vectors[1], parts);
+    if (size > MAX_BODY_SIZE)
         return false;
 
     last_id_++;
@@ -116,17 +221,133 @@ bool Fifo::write(const IDataObject &obj) {
 
     // Serialize header
     header.serialize(buffer_.data(), header_size);
+    vectors[0] = {buffer_.data(), header_size};
 
-    // Write data into pipe
-    const auto res = ::write(fd_, buffer_.data(), header_size + size);
+    // Small messages are read with a single call as a packet, larger ones would take a call per page
+    if (packet_)
+        set_packets(header_size + size <= PIPE_BUF);
 
+    // Write header and body without staging the payload
+    const auto res = write_vectors(vectors.data(), parts + 1);
     if (res == -1)
-        perror("Fifo::write (write)");
+        perror("Fifo::write (writev)");
 
     return res != -1;
 }
 
-std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> Fifo::read() {
+ssize_t Fifo::write_vectors(iovec *vectors, int count) {
+    if (uring_)
+        return ring_.write_all(fd_, vectors, count);
+
+    return splice_ ? write_spliced(vectors, count) : write_all(fd_, vectors, count);
+}
+
+void Fifo::set_packets(bool enabled) {
+    // Check if packets are supported and the mode changes
+    if (flags_ == -1 || direct_ == enabled)
+        return;
+
+    if (fcntl(fd_, F_SETFL, enabled ? flags_ | O_DIRECT : flags_) == -1) {
+        perror("Fifo::set_packets (fcntl)");
+        return;
+    }
+
+    direct_ = enabled;
+}
+
+ssize_t Fifo::write_spliced(iovec *vectors, int count) {
+    ssize_t total = 0;
+
+    while (count > 0) {
+        // Take the next run of parts, which are all copied or all spliced
+        const auto large = vectors->iov_len >= SPLICE_THRESHOLD;
+        int run = 1;
+        while (run < count && (vectors[run].iov_len >= SPLICE_THRESHOLD) == large)
+            run++;
+
+        // Small parts live in reused buffers, so only large parts are referenced by the pipe
+        if (!large) {
+            const auto res = write_all(fd_, vectors, run);
+            if (res == -1)
+                return -1;
+
+            total += res;
+        } else {
+            auto remaining = run;
+            auto parts = vectors;
+            while (remaining > 0) {
+                const auto res = vmsplice(fd_, parts, std::min(remaining, IOV_MAX), 0);
+                if (res == -1) {
+                    if (errno == EINTR)
+                        continue;
+
+                    return -1;
+                }
+
+                total += res;
+                remaining = advance_vectors(parts, remaining, res);
+            }
+        }
+
+        vectors += run;
+        count -= run;
+    }
+
+    return total;
+}
+
+unsigned int Fifo::write_batch(const std::vector<const IDataObject *> &objects) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if pipe is open
+    if (fd_ == -1)
+        return 0;
+
+    // Headers and small parts are serialized into the batch buffer, payloads are referenced directly
+    batch_.resize(objects.size() * BUFFER_SIZE);
+    vectors_.resize(objects.size() * MAX_PARTS);
+    const auto timestamp = get_timestamp();
+
+    int count = 0;
+    unsigned int amount = 0;
+    for (const auto obj: objects) {
+        const auto buffer = &batch_[amount * BUFFER_SIZE];
+        const auto parts = obj->serialize_parts(&buffer[header_size], BUFFER_SIZE - header_size,
+                                                &vectors_[count + 1], MAX_PARTS - 1);
+        if (parts == -1)
+            break;
+
+        const auto size = total_size(&vectors_[count + 1], parts);
+        if (size > MAX_BODY_SIZE)
+            break;
+
+        last_id_++;
+        DataHeader header(last_id_, obj->get_type(), size, timestamp);
+        header.serialize(buffer, header_size);
+        vectors_[count] = {buffer, header_size};
+
+        count += parts + 1;
+        amount++;
+    }
+
+    // Packets would cut the batch into pages, the reader parses the framed messages of a batch anyway
+    if (packet_)
+        set_packets(false);
+
+    // Write all messages, the kernel limits the amount of parts per call
+    for (int offset = 0; offset < count; offset += IOV_MAX) {
+        const auto amount = std::min(count - offset, IOV_MAX);
+        const auto res = write_vectors(&vectors_[offset], amount);
+        if (res == -1) {
+            perror("Fifo::write_batch (writev)");
+            return 0;
+        }
+    }
+
+    return amount;
+}
+
+std::variant<DataHeader, CommunicationError> Fifo::receive_header() {
     constexpr auto header_size = sizeof(DataHeader);
 
     // Check if pipe is open
@@ -134,43 +355,324 @@ std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> Fifo::read(
         return CommunicationError::CONNECTION_CLOSED;
 
     // Read data from pipe
-    auto result = ::read(fd_, buffer_.data(), header_size);
+    const auto result = ::read(fd_, receive_buffer_.data(), header_size);
     if (result == -1) {
         if (errno == EAGAIN)
             return CommunicationError::NO_DATA_AVAILABLE;
 
-        perror("Fifo::read (read)");
+        perror("Fifo::receive_header (read)");
         return CommunicationError::READ_ERROR;
     }
 
     if (result == 0)
         return CommunicationError::NO_DATA_AVAILABLE;
 
-    assert(header_size == result);
+    // Messages larger than the pipe buffer arrive in multiple parts
+    if (!read_exactly(&receive_buffer_[result], header_size - result))
+        return CommunicationError::READ_ERROR;
 
     // Deserialize header
-    const auto optional = DataHeader::deserialize(buffer_.data(), header_size);
-    if (!optional)
+    const auto optional = DataHeader::deserialize(receive_buffer_.data(), header_size);
+    if (!optional || optional->get_body_size() > MAX_BODY_SIZE)
         return CommunicationError::INVALID_HEADER;
 
-    const auto header = *optional;
+    return *optional;
+}
 
-    result = ::read(fd_, buffer_.data(), header.get_body_size());
-    if (result == -1) {
-        if (errno == EAGAIN)
-            return CommunicationError::NO_DATA_AVAILABLE;
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> Fifo::receive() {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    if (uring_ && fd_ != -1)
+        return receive_ring();
+
+    if (packet_ && fd_ != -1)
+        return receive_packet();
 
-        perror("Fifo::read (read)");
+    const auto result = receive_header();
+    if (std::holds_alternative<CommunicationError>(result))
+        return std::get<CommunicationError>(result);
+
+    // Grow the buffer once for messages larger than it, the memory is kept for later messages
+    const auto header = std::get<DataHeader>(result);
+    if (header_size + header.get_body_size() > receive_buffer_.size())
+        receive_buffer_.resize(header_size + header.get_body_size());
+
+    if (!read_exactly(&receive_buffer_[header_size], header.get_body_size()))
+        return CommunicationError::READ_ERROR;
+
+    return std::make_tuple(header, &receive_buffer_[header_size]);
+}
+
+std::variant<DataHeader, CommunicationError> Fifo::read_to(int fd) {
+    // The ring and packet mode read into their own buffer, so the pipe can't be spliced
+    if (uring_ || packet_) {
+        fprintf(stderr, "Fifo::read_to (Not supported with io_uring or packets)\n");
         return CommunicationError::READ_ERROR;
     }
 
-    assert(header.get_body_size() == result);
+    const auto result = receive_header();
+    if (std::holds_alternative<CommunicationError>(result))
+        return result;
+
+    // Move the body page by page, the header was already consumed
+    const auto header = std::get<DataHeader>(result);
+    std::size_t remaining = header.get_body_size();
+    while (remaining > 0) {
+        const auto res = ::splice(fd_, nullptr, fd, nullptr, remaining, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (res > 0) {
+            remaining -= res;
+            continue;
+        }
+
+        if (res == -1 && errno == EINTR)
+            continue;
+
+        if (res == -1 && errno != EAGAIN) {
+            perror("Fifo::read_to (splice)");
+            return CommunicationError::READ_ERROR;
+        }
+
+        // The sink is full, if the pipe still has data, so wait for the side which blocked
+        if (poll(fd_, 0) > 0) {
+            if (poll_write(fd, WAIT_TIME) <= 0) {
+                fprintf(stderr, "Fifo::read_to (Sink not writable)\n");
+                return CommunicationError::READ_ERROR;
+            }
+        } else if (poll(fd_, WAIT_TIME) <= 0) {
+            // Writer didn't continue the message
+            fprintf(stderr, "Fifo::read_to (Incomplete message)\n");
+            return CommunicationError::READ_ERROR;
+        }
+    }
+
+    return header;
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> Fifo::receive_packet() {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    while (true) {
+        const auto available = end_ - begin_;
+        auto required = static_cast<std::size_t>(PIPE_BUF);
+
+        if (available >= header_size) {
+            // Deserialize header of the next frame
+            const auto optional = DataHeader::deserialize(&receive_buffer_[begin_], header_size);
+            if (!optional || optional->get_body_size() > MAX_BODY_SIZE) {
+                // Framing is lost, so drop everything read so far
+                begin_ = end_ = 0;
+                return CommunicationError::INVALID_HEADER;
+            }
+
+            // Take the frame directly from the buffer if it is complete
+            const auto header = *optional;
+            const auto frame_size = header_size + header.get_body_size();
+            if (available >= frame_size) {
+                const auto body = &receive_buffer_[begin_ + header_size];
+                begin_ += frame_size;
+                return std::make_tuple(header, body);
+            }
+
+            required = std::max(required, frame_size - available);
+        }
+
+        // Move the partial frame to the front, if there is no room for a whole packet behind it
+        if (begin_ == end_) {
+            begin_ = end_ = 0;
+        } else if (receive_buffer_.size() - end_ < required) {
+            std::memmove(receive_buffer_.data(), &receive_buffer_[begin_], available);
+            begin_ = 0;
+            end_ = available;
+        }
+
+        // Grow the buffer once for frames larger than it, the memory is kept for later messages
+        if (receive_buffer_.size() - end_ < required)
+            receive_buffer_.resize(end_ + required);
+
+        // Read one packet, or as many framed messages as fit into the buffer
+        const auto res = ::read(fd_, &receive_buffer_[end_], receive_buffer_.size() - end_);
+        if (res == -1) {
+            if (errno == EINTR)
+                continue;
+
+            if (errno == EAGAIN)
+                return CommunicationError::NO_DATA_AVAILABLE;
+
+            perror("Fifo::receive_packet (read)");
+            return CommunicationError::READ_ERROR;
+        }
+
+        if (res == 0)
+            return CommunicationError::NO_DATA_AVAILABLE;
+
+        end_ += res;
+    }
+}
+
+bool Fifo::read_exactly(std::byte *buffer, std::size_t size) {
+    while (size > 0) {
+        const auto result = ::read(fd_, buffer, size);
+        if (result > 0) {
+            buffer += result;
+            size -= result;
+            continue;
+        }
+
+        if (result == -1 && errno == EINTR)
+            continue;
 
-    const auto body = deserialize_data_object(header.get_type(), buffer_.data(), header.get_body_size());
+        if (result == -1 && errno != EAGAIN) {
+            perror("Fifo::read_exactly (read)");
+            return false;
+        }
+
+        // Wait for the writer to continue the message
+        if (poll(fd_, WAIT_TIME) <= 0) {
+            fprintf(stderr, "Fifo::read_exactly (Incomplete message)\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> Fifo::receive_ring() {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    while (true) {
+        const auto available = end_ - begin_;
+
+        if (available >= header_size) {
+            // Deserialize header of the next frame
+            const auto optional = DataHeader::deserialize(&receive_buffer_[begin_], header_size);
+            if (!optional || optional->get_body_size() > MAX_BODY_SIZE) {
+                // Framing is lost, so drop everything read so far
+                begin_ = end_ = 0;
+                return CommunicationError::INVALID_HEADER;
+            }
+
+            // Take the frame directly from the buffer if it is complete
+            const auto header = *optional;
+            const auto frame_size = header_size + header.get_body_size();
+            if (available >= frame_size) {
+                const auto body = &receive_buffer_[begin_ + header_size];
+                begin_ += frame_size;
+                return std::make_tuple(header, body);
+            }
+        }
+
+        // Start reading the rest, a pipe with data completes the read right away
+        if (!reading_) {
+            if (!arm_ring())
+                return CommunicationError::READ_ERROR;
+
+            continue;
+        }
+
+        // Take the completion of the read in flight
+        const auto completion = ring_.peek();
+        if (completion == nullptr)
+            return CommunicationError::NO_DATA_AVAILABLE;
+
+        const auto res = completion->res;
+        ring_.seen();
+        reading_ = false;
+
+        if (res < 0 && res != -EINTR && res != -EAGAIN) {
+            errno = -res;
+            perror("Fifo::receive_ring (read)");
+            return CommunicationError::READ_ERROR;
+        }
+
+        if (res > 0)
+            end_ += res;
+    }
+}
+
+bool Fifo::arm_ring() {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if a read is already in flight
+    if (reading_)
+        return true;
+
+    // Move the partial frame to the front to make room for more data
+    const auto available = end_ - begin_;
+    if (begin_ > 0) {
+        std::memmove(receive_buffer_.data(), &receive_buffer_[begin_], available);
+        begin_ = 0;
+        end_ = available;
+    }
+
+    // Grow the buffer once for frames larger than it, it has to be registered again after moving
+    if (available >= header_size) {
+        const auto optional = DataHeader::deserialize(receive_buffer_.data(), header_size);
+        const auto frame_size = optional ? header_size + optional->get_body_size() : 0;
+
+        if (optional && optional->get_body_size() <= MAX_BODY_SIZE && frame_size > receive_buffer_.size()) {
+            receive_buffer_.resize(frame_size);
+            const iovec buffer{receive_buffer_.data(), receive_buffer_.size()};
+            fixed_ = ring_.register_buffers(&buffer, 1);
+        }
+    }
+
+    // Read behind the buffered data, plain reads are used if the buffer couldn't be registered
+    const auto sqe = ring_.prepare(fixed_ ? IORING_OP_READ_FIXED : IORING_OP_READ, fd_, READ_REQUEST);
+    if (sqe == nullptr)
+        return false;
+
+    sqe->addr = reinterpret_cast<std::uint64_t>(&receive_buffer_[end_]);
+    sqe->len = static_cast<std::uint32_t>(receive_buffer_.size() - end_);
+    sqe->off = static_cast<std::uint64_t>(-1);
+    sqe->buf_index = 0;
+
+    if (ring_.submit() == -1)
+        return false;
+
+    reading_ = true;
+    return true;
+}
+
+bool Fifo::buffered() const {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if the header of the next frame is complete
+    const auto available = end_ - begin_;
+    if (available < header_size)
+        return false;
+
+    // Invalid headers are reported by the next read
+    const auto optional = DataHeader::deserialize(&receive_buffer_[begin_], header_size);
+    return !optional || available >= header_size + optional->get_body_size();
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> Fifo::read() {
+    // Receive message into buffer
+    const auto message = receive();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
 
     if (std::holds_alternative<DataObject>(body)) {
-        const auto obj = std::get<DataObject>(body);
-        return std::make_tuple(header, obj);
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> Fifo::read_view() {
+    // Receive message into buffer, the view is valid until the next read
+    const auto message = receive();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    const auto body = deserialize_data_object_view(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObjectView>(body)) {
+        return std::make_tuple(header, std::get<DataObjectView>(body));
     } else {
         return std::get<CommunicationError>(body);
     }
@@ -0,0 +1,122 @@
+#include "handler/fragmentation.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utility.hpp"
+
+namespace ipc {
+
+int Fragmenter::split(const IDataObject &obj, unsigned int limit) {
+    constexpr auto header_size = sizeof(DataHeader);
+    constexpr auto max_parts = ICommunicationHandler::MAX_PARTS;
+
+    // Check if limit leaves room for fragments
+    if (limit <= Fragment::PREFIX_SIZE)
+        return -1;
+
+    // Measure the body, its small parts are only needed for this check
+    std::array<iovec, max_parts - 1> probe_parts{};
+    const auto probe_count = obj.serialize_parts(probe_.data(), probe_.size(), probe_parts.data(), probe_parts.size());
+    if (probe_count == -1)
+        return -1;
+
+    const auto size = total_size(probe_parts.data(), probe_count);
+    if (size <= limit)
+        return 0;
+
+    if (size > ICommunicationHandler::MAX_BODY_SIZE)
+        return -1;
+
+    // Describe header and body of the whole message, the small parts are kept until all fragments are written
+    const auto count = obj.serialize_parts(&message_[header_size], message_.size() - header_size,
+                                           &parts_[1], max_parts - 1);
+    if (count == -1)
+        return -1;
+
+    DataHeader header(0, obj.get_type(), size, get_timestamp());
+    header.serialize(message_.data(), header_size);
+    parts_[0] = {message_.data(), header_size};
+
+    count_ = count + 1;
+    total_ = header_size + size;
+    chunk_ = limit - Fragment::PREFIX_SIZE;
+
+    return static_cast<int>((total_ + chunk_ - 1) / chunk_);
+}
+
+bool Fragmenter::write(ICommunicationHandler &handler) {
+    for (std::size_t offset = 0; offset < total_; offset += chunk_) {
+        fragment_.assign(parts_.data(), count_, offset, std::min(chunk_, total_ - offset));
+        if (!handler.write(fragment_))
+            return false;
+    }
+
+    return true;
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> Reassembler::add(
+        const DataHeader &header, const std::byte *data) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if fragment contains its offset
+    if (header.get_body_size() < Fragment::PREFIX_SIZE)
+        return CommunicationError::INVALID_DATA;
+
+    std::uint32_t offset;
+    std::memcpy(&offset, data, sizeof(offset));
+    const auto length = header.get_body_size() - Fragment::PREFIX_SIZE;
+
+    // A fragment which doesn't continue the current message means fragments got lost
+    if (offset != received_) {
+        received_ = 0;
+        expected_ = 0;
+
+        // Skip fragments until the next message starts
+        if (offset != 0)
+            return CommunicationError::NO_DATA_AVAILABLE;
+    }
+
+    if (offset == 0)
+        id_ = header.get_id();
+
+    // Check if fragment exceeds the message
+    if ((expected_ != 0 && received_ + length > expected_) || received_ + length > header_size + ICommunicationHandler::MAX_BODY_SIZE) {
+        received_ = 0;
+        expected_ = 0;
+        return CommunicationError::INVALID_DATA;
+    }
+
+    // Collect fragment, the buffer is kept for later messages
+    if (received_ + length > buffer_.size())
+        buffer_.resize(received_ + length);
+
+    std::memcpy(&buffer_[received_], &data[Fragment::PREFIX_SIZE], length);
+    received_ += length;
+
+    // Deserialize header of the whole message as soon as it is available
+    if (expected_ == 0 && received_ >= header_size) {
+        const auto optional = DataHeader::deserialize(buffer_.data(), header_size);
+        if (!optional || !optional->is_valid() || optional->get_body_size() > ICommunicationHandler::MAX_BODY_SIZE) {
+            received_ = 0;
+            return CommunicationError::INVALID_HEADER;
+        }
+
+        expected_ = header_size + optional->get_body_size();
+        if (expected_ > buffer_.size())
+            buffer_.resize(expected_);
+    }
+
+    // Check if message is complete
+    if (expected_ == 0 || received_ < expected_)
+        return CommunicationError::NO_DATA_AVAILABLE;
+
+    const auto message = *DataHeader::deserialize(buffer_.data(), header_size);
+    received_ = 0;
+    expected_ = 0;
+
+    return std::make_tuple(DataHeader(id_, message.get_type(), message.get_body_size(), message.get_timestamp()),
+                           &buffer_[header_size]);
+}
+
+}
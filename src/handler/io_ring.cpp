@@ -0,0 +1,392 @@
+#include "handler/io_ring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+
+extern "C" {
+#include <linux/time_types.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+}
+
+#include "utility.hpp"
+
+namespace ipc {
+
+static int io_uring_enter(int fd, unsigned int submit, unsigned int wait, unsigned int flags,
+                          const void *argument = nullptr, std::size_t size = 0) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, submit, wait, flags, argument, size));
+}
+
+IoRing::~IoRing() {
+    if (fd_ != -1) {
+        IoRing::close();
+    }
+}
+
+bool IoRing::open(unsigned int entries) {
+    // Check if ring is already open
+    if (fd_ != -1)
+        return true;
+
+    // Create ring
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CLAMP;
+
+    fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd_ == -1) {
+        perror("IoRing::open (io_uring_setup)");
+        return false;
+    }
+
+    // Both queues share a single mapping on newer kernels
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    const auto single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single)
+        sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+    // Map queues
+    auto addr = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+    if (addr == MAP_FAILED) {
+        perror("IoRing::open (mmap)");
+        close();
+        return false;
+    }
+
+    sq_address_ = addr;
+
+    if (single) {
+        cq_address_ = sq_address_;
+    } else {
+        addr = mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        if (addr == MAP_FAILED) {
+            perror("IoRing::open (mmap)");
+            close();
+            return false;
+        }
+
+        cq_address_ = addr;
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    addr = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+    if (addr == MAP_FAILED) {
+        perror("IoRing::open (mmap)");
+        close();
+        return false;
+    }
+
+    sqes_ = static_cast<io_uring_sqe *>(addr);
+
+    // Resolve the fields of both queues
+    const auto sq = static_cast<std::byte *>(sq_address_);
+    sq_head_ = reinterpret_cast<std::atomic<std::uint32_t> *>(&sq[params.sq_off.head]);
+    sq_tail_ = reinterpret_cast<std::atomic<std::uint32_t> *>(&sq[params.sq_off.tail]);
+    sq_mask_ = *reinterpret_cast<std::uint32_t *>(&sq[params.sq_off.ring_mask]);
+    sq_entries_ = params.sq_entries;
+    sqe_tail_ = sq_tail_->load(std::memory_order_relaxed);
+
+    const auto cq = static_cast<std::byte *>(cq_address_);
+    cq_head_ = reinterpret_cast<std::atomic<std::uint32_t> *>(&cq[params.cq_off.head]);
+    cq_tail_ = reinterpret_cast<std::atomic<std::uint32_t> *>(&cq[params.cq_off.tail]);
+    cq_mask_ = *reinterpret_cast<std::uint32_t *>(&cq[params.cq_off.ring_mask]);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(&cq[params.cq_off.cqes]);
+
+    // Every slot of the submission queue always points at the entry with the same index
+    const auto array = reinterpret_cast<std::uint32_t *>(&sq[params.sq_off.array]);
+    for (std::uint32_t i = 0; i < sq_entries_; ++i)
+        array[i] = i;
+
+    return true;
+}
+
+void IoRing::close() {
+    // Check if ring is already closed
+    if (fd_ == -1)
+        return;
+
+    // Closing the ring cancels all requests and unregisters all buffers
+    ::close(fd_);
+    fd_ = -1;
+
+    if (sqes_ != nullptr)
+        munmap(sqes_, sqes_size_);
+    if (cq_address_ != nullptr && cq_address_ != sq_address_)
+        munmap(cq_address_, cq_size_);
+    if (sq_address_ != nullptr)
+        munmap(sq_address_, sq_size_);
+    if (buffer_ring_ != nullptr)
+        munmap(buffer_ring_, buffers_size_);
+
+    sqes_ = nullptr;
+    sq_address_ = nullptr;
+    cq_address_ = nullptr;
+    buffer_ring_ = nullptr;
+    buffers_ = nullptr;
+    buffer_count_ = 0;
+    registered_ = false;
+
+    deferred_.clear();
+    next_deferred_ = 0;
+}
+
+io_uring_sqe *IoRing::prepare(std::uint8_t opcode, int fd, std::uint64_t data) {
+    // Check if ring is open
+    if (fd_ == -1)
+        return nullptr;
+
+    // Submit pending entries if the queue is full
+    if (sqe_tail_ - sq_head_->load(std::memory_order_acquire) >= sq_entries_) {
+        if (submit() == -1 || sqe_tail_ - sq_head_->load(std::memory_order_acquire) >= sq_entries_)
+            return nullptr;
+    }
+
+    const auto sqe = &sqes_[sqe_tail_ & sq_mask_];
+    *sqe = {};
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->user_data = data;
+
+    sqe_tail_++;
+    return sqe;
+}
+
+int IoRing::submit(unsigned int wait) {
+    // Check if ring is open
+    if (fd_ == -1)
+        return -1;
+
+    // Publish prepared entries, the kernel consumes them while entering
+    sq_tail_->store(sqe_tail_, std::memory_order_release);
+    const auto pending = sqe_tail_ - sq_head_->load(std::memory_order_acquire);
+    if (pending == 0 && wait == 0)
+        return 0;
+
+    while (true) {
+        const auto res = io_uring_enter(fd_, pending, wait, wait > 0 ? IORING_ENTER_GETEVENTS : 0);
+        if (res == -1 && errno == EINTR)
+            continue;
+
+        if (res == -1)
+            perror("IoRing::submit (io_uring_enter)");
+
+        return res;
+    }
+}
+
+bool IoRing::ready() const {
+    return next_deferred_ < deferred_.size()
+           || cq_head_->load(std::memory_order_relaxed) != cq_tail_->load(std::memory_order_acquire);
+}
+
+int IoRing::wait(int timeout) {
+    // Check if ring is open
+    if (fd_ == -1)
+        return -1;
+
+    // Check if a completion is available without any syscall
+    if (ready())
+        return 1;
+
+    // Publish prepared entries and block until a completion arrives or the time expired
+    sq_tail_->store(sqe_tail_, std::memory_order_release);
+    const auto pending = sqe_tail_ - sq_head_->load(std::memory_order_acquire);
+
+    __kernel_timespec time{};
+    time.tv_sec = timeout / 1000;
+    time.tv_nsec = (timeout % 1000) * 1000000;
+
+    io_uring_getevents_arg argument{};
+    argument.sigmask_sz = _NSIG / 8;
+    argument.ts = timeout < 0 ? 0 : reinterpret_cast<std::uint64_t>(&time);
+
+    const auto res = io_uring_enter(fd_, pending, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                                    &argument, sizeof(argument));
+    if (res == -1 && errno != ETIME && errno != EINTR) {
+        perror("IoRing::wait (io_uring_enter)");
+        return -1;
+    }
+
+    return ready() ? 1 : 0;
+}
+
+const io_uring_cqe *IoRing::peek() const {
+    // Completions put aside while waiting for a request come first
+    if (next_deferred_ < deferred_.size())
+        return &deferred_[next_deferred_];
+
+    const auto head = cq_head_->load(std::memory_order_relaxed);
+    if (head == cq_tail_->load(std::memory_order_acquire))
+        return nullptr;
+
+    return &cqes_[head & cq_mask_];
+}
+
+void IoRing::seen() {
+    if (next_deferred_ < deferred_.size()) {
+        // Keep the memory of the put aside completions
+        if (++next_deferred_ == deferred_.size()) {
+            deferred_.clear();
+            next_deferred_ = 0;
+        }
+
+        return;
+    }
+
+    cq_head_->store(cq_head_->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+int IoRing::complete(std::uint64_t data) {
+    // Check if ring is open
+    if (fd_ == -1)
+        return -EBADF;
+
+    // The completion may have been put aside already
+    for (auto i = next_deferred_; i < deferred_.size(); ++i) {
+        if (deferred_[i].user_data == data) {
+            const auto res = deferred_[i].res;
+            deferred_.erase(deferred_.begin() + static_cast<std::ptrdiff_t>(i));
+            return res;
+        }
+    }
+
+    while (true) {
+        // Take completions from the queue and put aside the ones of other requests
+        auto head = cq_head_->load(std::memory_order_relaxed);
+        while (head != cq_tail_->load(std::memory_order_acquire)) {
+            const auto completion = cqes_[head & cq_mask_];
+            cq_head_->store(++head, std::memory_order_release);
+
+            if (completion.user_data == data)
+                return completion.res;
+
+            deferred_.push_back(completion);
+        }
+
+        // Submit pending entries and wait for the next completion
+        if (submit(1) == -1)
+            return -errno;
+    }
+}
+
+bool IoRing::register_buffers(const iovec *buffers, unsigned int count) {
+    // Check if ring is open
+    if (fd_ == -1)
+        return false;
+
+    // Only one set of buffers can be registered at a time
+    if (registered_) {
+        syscall(__NR_io_uring_register, fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        registered_ = false;
+    }
+
+    if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, buffers, count) == -1) {
+        perror("IoRing::register_buffers (io_uring_register)");
+        return false;
+    }
+
+    registered_ = true;
+    return true;
+}
+
+bool IoRing::provide_buffers(unsigned int count, unsigned int size) {
+    // Check if ring is open and buffers are not provided yet
+    if (fd_ == -1 || buffer_ring_ != nullptr || count == 0 || (count & (count - 1)) != 0)
+        return false;
+
+    // Buffer ring and buffers share a single mapping, the ring has to be page aligned
+    const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const auto ring_size = (count * sizeof(io_uring_buf) + page - 1) / page * page;
+    buffers_size_ = ring_size + static_cast<std::size_t>(count) * size;
+
+    const auto addr = mmap(nullptr, buffers_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+        perror("IoRing::provide_buffers (mmap)");
+        return false;
+    }
+
+    buffer_ring_ = static_cast<io_uring_buf_ring *>(addr);
+    buffers_ = &static_cast<std::byte *>(addr)[ring_size];
+    buffer_count_ = count;
+    buffer_size_ = size;
+    buffer_tail_ = 0;
+
+    // Register ring as buffer group 0
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<std::uint64_t>(buffer_ring_);
+    reg.ring_entries = count;
+    reg.bgid = 0;
+
+    if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PBUF_RING, &reg, 1) == -1) {
+        perror("IoRing::provide_buffers (io_uring_register)");
+        munmap(buffer_ring_, buffers_size_);
+        buffer_ring_ = nullptr;
+        buffers_ = nullptr;
+        buffer_count_ = 0;
+        return false;
+    }
+
+    // Hand all buffers to the kernel
+    for (unsigned int i = 0; i < count; ++i)
+        recycle(i << IORING_CQE_BUFFER_SHIFT);
+
+    return true;
+}
+
+std::byte *IoRing::provided(std::uint32_t flags) const {
+    const auto id = flags >> IORING_CQE_BUFFER_SHIFT;
+    return &buffers_[static_cast<std::size_t>(id) * buffer_size_];
+}
+
+void IoRing::recycle(std::uint32_t flags) {
+    const auto id = flags >> IORING_CQE_BUFFER_SHIFT;
+
+    // Only fill address, length and id, the tail of the ring overlays the reserved field of the first buffer.
+    // The flexible array of the kernel header is shifted in C++, so the ring is indexed as plain array.
+    auto &buffer = reinterpret_cast<io_uring_buf *>(buffer_ring_)[buffer_tail_ & (buffer_count_ - 1)];
+    buffer.addr = reinterpret_cast<std::uint64_t>(provided(flags));
+    buffer.len = buffer_size_;
+    buffer.bid = static_cast<std::uint16_t>(id);
+
+    buffer_tail_++;
+    __atomic_store_n(&buffer_ring_->tail, buffer_tail_, __ATOMIC_RELEASE);
+}
+
+ssize_t IoRing::write_all(int fd, iovec *vectors, int count) {
+    ssize_t total = 0;
+
+    while (count > 0) {
+        const auto data = WRITE_DATA | next_write_++;
+        const auto sqe = prepare(IORING_OP_WRITEV, fd, data);
+        if (sqe == nullptr) {
+            errno = EBUSY;
+            return -1;
+        }
+
+        sqe->addr = reinterpret_cast<std::uint64_t>(vectors);
+        sqe->len = count;
+        sqe->off = static_cast<std::uint64_t>(-1);
+
+        // Submit and wait for the write in a single call
+        const auto res = complete(data);
+        if (res < 0) {
+            if (res == -EINTR || res == -EAGAIN)
+                continue;
+
+            errno = -res;
+            return -1;
+        }
+
+        total += res;
+        count = advance_vectors(vectors, count, res);
+    }
+
+    return total;
+}
+
+}
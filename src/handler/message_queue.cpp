@@ -1,6 +1,9 @@
 #include "handler/message_queue.hpp"
 
-#include <cassert>
+#include <algorithm>
+#include <cerrno>
+#include <ctime>
+#include <fstream>
 #include <utility>
 
 extern "C" {
@@ -13,8 +16,11 @@ extern "C" {
 
 namespace ipc {
 
-MessageQueue::MessageQueue(std::string path, bool readonly)
-        : path_(std::move(path)), readonly_(readonly) {}
+/// Limit of the depth for processes without CAP_SYS_RESOURCE.
+static constexpr auto MESSAGE_LIMIT_PATH = "/proc/sys/fs/mqueue/msg_max";
+
+MessageQueue::MessageQueue(std::string path, bool readonly, long depth)
+        : path_(std::move(path)), readonly_(readonly), depth_(std::max(depth, 1L)) {}
 
 MessageQueue::~MessageQueue() {
     if (mqd_ != -1) {
@@ -34,12 +40,29 @@ bool MessageQueue::open() {
     // Configure block size
     mq_attr attr{};
     attr.mq_msgsize = BUFFER_SIZE;
-    attr.mq_maxmsg = QUEUE_SIZE;
+    attr.mq_maxmsg = depth_;
+
+    // Create and open message queue, the reader blocks inside the receive call instead of polling before
+    mqd_ = mq_open(path_.c_str(), O_RDWR | O_CREAT, 0660, &attr);
+    auto error = mqd_ == -1 ? errno : 0;
+
+    // Reduce the depth to the limit of the system first and further until the queue fits the resource limit
+    long limit = 0;
+    if (error == EINVAL && std::ifstream(MESSAGE_LIMIT_PATH) >> limit && limit < attr.mq_maxmsg) {
+        attr.mq_maxmsg = limit;
+        mqd_ = mq_open(path_.c_str(), O_RDWR | O_CREAT, 0660, &attr);
+        error = mqd_ == -1 ? errno : 0;
+    }
+
+    while (mqd_ == -1 && (error == EINVAL || error == EMFILE) && attr.mq_maxmsg > 1) {
+        attr.mq_maxmsg /= 2;
+        mqd_ = mq_open(path_.c_str(), O_RDWR | O_CREAT, 0660, &attr);
+        error = mqd_ == -1 ? errno : 0;
+    }
 
-    // Create and open message queue
-    const auto flag = readonly_ ? O_RDWR | O_CREAT | O_NONBLOCK : O_RDWR | O_CREAT;
-    mqd_ = mq_open(path_.c_str(), flag, 0660, &attr);
     if (mqd_ == -1) {
+        // Reading the limit may have changed errno since
+        errno = error;
         perror("MessageQueue::open (mq_open)");
 
         if (readonly_)
@@ -47,6 +70,14 @@ bool MessageQueue::open() {
         return false;
     }
 
+    // The queue may already exist, so its actual depth is taken
+    if (mq_getattr(mqd_, &attr) == 0) {
+        if (readonly_ && attr.mq_maxmsg < depth_)
+            fprintf(stderr, "MessageQueue::open (Depth reduced to %ld)\n", attr.mq_maxmsg);
+
+        depth_ = attr.mq_maxmsg;
+    }
+
     return true;
 }
 
@@ -60,6 +91,7 @@ bool MessageQueue::close() {
     if (readonly_)
         mq_unlink(path_.c_str());
     mqd_ = -1;
+    received_ = 0;
 
     return true;
 }
@@ -73,12 +105,19 @@ bool MessageQueue::await_data() {
     if (mqd_ == -1)
         return false;
 
-    // Poll events and block until one is available
-    const auto res = poll(mqd_, WAIT_TIME);
-    if (res == -1)
-        perror("MessageQueue::await_data (poll)");
+    // A message was already taken
+    if (received_ > 0)
+        return true;
 
-    return res > 0;
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return poll(mqd_, 0) > 0; }))
+        return true;
+
+    if (!may_block())
+        return false;
+
+    // Block until a message arrives and take it with the same call
+    return take(WAIT_TIME);
 }
 
 bool MessageQueue::has_data() const {
@@ -86,6 +125,9 @@ bool MessageQueue::has_data() const {
     if (mqd_ == -1)
         return false;
 
+    if (received_ > 0)
+        return true;
+
     // Poll events and block for 1ms
     const auto res = poll(mqd_, 1);
     if (res == -1)
@@ -94,6 +136,11 @@ bool MessageQueue::has_data() const {
     return res > 0;
 }
 
+int MessageQueue::descriptor() const {
+    // Message queue descriptors are pollable on Linux
+    return mqd_;
+}
+
 bool MessageQueue::write(const IDataObject &obj) {
     constexpr auto header_size = sizeof(DataHeader);
 
@@ -101,6 +148,11 @@ bool MessageQueue::write(const IDataObject &obj) {
     if (mqd_ == -1)
         return false;
 
+    // Split objects which don't fit into a single message
+    const auto fragments = fragmenter_.split(obj, BUFFER_SIZE - header_size);
+    if (fragments != 0)
+        return fragments != -1 && fragmenter_.write(*this);
+
     // Serialize body
     const auto timestamp = get_timestamp();
     const auto size = obj.serialize(&buffer_[header_size], BUFFER_SIZE - header_size);
@@ -113,44 +165,105 @@ bool MessageQueue::write(const IDataObject &obj) {
     // Serialize header
     header.serialize(buffer_.data(), header_size);
 
-    // Write data into message queue
-    const auto res = mq_send(mqd_, reinterpret_cast<const char *>(buffer_.data()), header_size + size, 0);
+    // Write data into message queue, messages of higher priority are received first
+    const auto res = mq_send(mqd_, reinterpret_cast<const char *>(buffer_.data()), header_size + size,
+                             priority(obj.get_type()));
     if (res == -1)
         perror("MessageQueue::write (mq_send)");
 
     return res != -1;
 }
 
-std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> MessageQueue::read() {
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> MessageQueue::receive() {
     constexpr auto header_size = sizeof(DataHeader);
 
     // Check if message queue is open
     if (mqd_ == -1)
         return CommunicationError::CONNECTION_CLOSED;
 
-    // Read data from message queue
-    const auto result = mq_receive(mqd_, reinterpret_cast<char *>(buffer_.data()), BUFFER_SIZE, nullptr);
-    if (result == -1) {
-        if (errno == EAGAIN)
-            return CommunicationError::NO_DATA_AVAILABLE;
+    // Read data from message queue, unless await_data already took a message
+    if (received_ == 0 && !take(0))
+        return errno == ETIMEDOUT || errno == EAGAIN ? CommunicationError::NO_DATA_AVAILABLE
+                                                       : CommunicationError::READ_ERROR;
 
-        perror("MessageQueue::read (mq_receive)");
-        return CommunicationError::READ_ERROR;
-    }
+    const auto result = received_;
+    received_ = 0;
 
     // Deserialize header
     const auto optional = DataHeader::deserialize(buffer_.data(), header_size);
-    if (!optional)
+    if (!optional || static_cast<std::size_t>(result) != header_size + optional->get_body_size())
         return CommunicationError::INVALID_HEADER;
 
-    const auto header = *optional;
-    assert(header.get_body_size() == result - header_size);
+    return std::make_tuple(*optional, &buffer_[header_size]);
+}
+
+bool MessageQueue::take(int timeout) {
+    // A deadline in the past returns immediately, if the queue is empty
+    timespec deadline{};
+    if (timeout > 0) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (timeout % 1000) * 1000 * 1000;
+        if (deadline.tv_nsec >= 1000 * 1000 * 1000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000 * 1000 * 1000;
+        }
+    }
+
+    ssize_t result;
+    do {
+        result = mq_timedreceive(mqd_, reinterpret_cast<char *>(buffer_.data()), BUFFER_SIZE, nullptr, &deadline);
+    } while (result == -1 && errno == EINTR);
+
+    if (result == -1) {
+        if (errno != ETIMEDOUT && errno != EAGAIN)
+            perror("MessageQueue::take (mq_timedreceive)");
+
+        return false;
+    }
 
-    const auto body = deserialize_data_object(header.get_type(), &buffer_[header_size], header.get_body_size());
+    received_ = result;
+    return true;
+}
+
+unsigned int MessageQueue::priority(DataType type) {
+    switch (type) {
+        case DataType::PING:
+            return 2;
+        case DataType::JAVA_SYMBOL_LOOKUP:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> MessageQueue::read() {
+    // Receive message into buffer, fragments are reassembled on the way
+    const auto message = reassembler_.receive([this] { return receive(); });
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
 
     if (std::holds_alternative<DataObject>(body)) {
-        const auto obj = std::get<DataObject>(body);
-        return std::make_tuple(header, obj);
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> MessageQueue::read_view() {
+    // Receive message into buffer, the view is valid until the next read or fragment
+    const auto message = reassembler_.receive([this] { return receive(); });
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    const auto body = deserialize_data_object_view(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObjectView>(body)) {
+        return std::make_tuple(header, std::get<DataObjectView>(body));
     } else {
         return std::get<CommunicationError>(body);
     }
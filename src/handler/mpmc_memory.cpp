@@ -0,0 +1,327 @@
+#include "handler/mpmc_memory.hpp"
+
+#include <cerrno>
+#include <climits>
+#include <utility>
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+#include "utility.hpp"
+
+namespace ipc {
+
+MpmcMemory::MpmcMemory(std::string name, bool server)
+        : name_(std::move(name)), server_(server) {}
+
+MpmcMemory::~MpmcMemory() {
+    if (fd_ != -1) {
+        MpmcMemory::close();
+    }
+}
+
+bool MpmcMemory::open() {
+    // Check if memory is already open
+    if (fd_ != -1)
+        return true;
+
+    if (server_) {
+        // Create memory
+        shm_unlink(name_.c_str());
+        fd_ = shm_open(name_.c_str(), O_RDWR | O_CREAT, 0660);
+    } else {
+        // Open memory
+        fd_ = shm_open(name_.c_str(), O_RDWR, 0660);
+    }
+
+    if (fd_ == -1) {
+        perror("MpmcMemory::open (shm_open)");
+        return false;
+    }
+
+    if (server_) {
+        // Resize memory
+        if (ftruncate(fd_, TOTAL_SIZE) == -1) {
+            perror("MpmcMemory::open (ftruncate)");
+            close();
+            return false;
+        }
+    }
+
+    // Allocate memory
+    auto addr = mmap(nullptr, TOTAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        perror("MpmcMemory::open (mmap)");
+        close();
+        return false;
+    }
+
+    address_ = static_cast<std::byte *>(addr);
+    control_ = reinterpret_cast<Control *>(address_);
+
+    if (server_) {
+        // Every slot starts free for the writer of its position
+        for (std::uint32_t i = 0; i < TOTAL_AMOUNT; ++i)
+            slot(i)->sequence.store(i, std::memory_order_relaxed);
+
+        control_->next_id.store(1, std::memory_order_release);
+    }
+
+    return true;
+}
+
+bool MpmcMemory::close() {
+    // Check if memory is already closed
+    if (fd_ == -1)
+        return false;
+
+    if (address_ != nullptr)
+        munmap(address_, TOTAL_SIZE);
+    address_ = nullptr;
+    control_ = nullptr;
+
+    ::close(fd_);
+    fd_ = -1;
+
+    if (server_)
+        shm_unlink(name_.c_str());
+
+    return true;
+}
+
+bool MpmcMemory::is_open() const {
+    return fd_ != -1;
+}
+
+bool MpmcMemory::ready() const {
+    const auto position = control_->dequeue_position.load(std::memory_order_relaxed);
+    return slot(position)->sequence.load(std::memory_order_acquire) == position + 1;
+}
+
+bool MpmcMemory::await_data() {
+    // Check if memory is already closed
+    if (fd_ == -1)
+        return false;
+
+    // Check if data is available without any syscall
+    if (ready())
+        return true;
+
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return ready(); }))
+        return true;
+
+    if (!may_block())
+        return false;
+
+    // Announce sleep and check again, so writers can't miss it
+    control_->readers_waiting.fetch_add(1, std::memory_order_seq_cst);
+    const auto signal = control_->data_signal.load(std::memory_order_seq_cst);
+
+    auto available = ready();
+    if (!available) {
+        // Wait for data
+        const auto res = futex_wait(&control_->data_signal, signal, WAIT_TIME);
+        if (res == -1 && errno != ETIMEDOUT && errno != EAGAIN && errno != EINTR)
+            perror("MpmcMemory::await_data (futex_wait)");
+
+        available = ready();
+    }
+
+    control_->readers_waiting.fetch_sub(1, std::memory_order_relaxed);
+    return available;
+}
+
+bool MpmcMemory::has_data() const {
+    // Check if memory is already closed
+    if (fd_ == -1)
+        return false;
+
+    // Check if data is available
+    return ready();
+}
+
+bool MpmcMemory::write(const IDataObject &obj) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Claim a free slot and serialize body directly into it
+    const auto buffer = reserve(BUFFER_SIZE - header_size);
+    if (buffer == nullptr)
+        return false;
+
+    // Slot is already claimed, so publish an invalid message on errors
+    const auto size = obj.serialize(buffer, BUFFER_SIZE - header_size);
+    const auto type = size == -1 ? DataType::INVALID : obj.get_type();
+
+    return commit(type, size == -1 ? 0 : size) && size != -1;
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> MpmcMemory::read() {
+    // Continue after a message which is still viewed
+    release_view();
+
+    // Claim a filled slot and get message directly from it
+    const auto message = peek_message();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
+    release();
+
+    if (std::holds_alternative<DataObject>(body)) {
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> MpmcMemory::read_view() {
+    // Get view directly into the transport, it is released on the next read
+    return peek_view();
+}
+
+std::byte *MpmcMemory::reserve(unsigned int size) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is already closed or message is too large
+    if (fd_ == -1 || header_size + size > BUFFER_SIZE)
+        return nullptr;
+
+    // A claimed slot must be committed before claiming the next one
+    if (reserved_ != nullptr)
+        return &data(reserved_)[header_size];
+
+    timestamp_ = get_timestamp();
+
+    // Claim a free slot
+    Slot *s;
+    auto position = control_->enqueue_position.load(std::memory_order_relaxed);
+    while (true) {
+        s = slot(position);
+        const auto sequence = s->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int32_t>(sequence - position);
+
+        if (diff == 0) {
+            // Slot is free, try to claim it
+            if (control_->enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // Queue is full, announce sleep and check again, so readers can't miss it
+            control_->writers_waiting.fetch_add(1, std::memory_order_seq_cst);
+            const auto signal = control_->space_signal.load(std::memory_order_seq_cst);
+
+            if (s->sequence.load(std::memory_order_seq_cst) == sequence) {
+                const auto res = futex_wait(&control_->space_signal, signal, WAIT_TIME);
+                if (res == -1 && errno != ETIMEDOUT && errno != EAGAIN && errno != EINTR) {
+                    perror("MpmcMemory::reserve (futex_wait)");
+                    control_->writers_waiting.fetch_sub(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+            }
+
+            control_->writers_waiting.fetch_sub(1, std::memory_order_relaxed);
+            position = control_->enqueue_position.load(std::memory_order_relaxed);
+        } else {
+            // Another writer claimed the slot
+            position = control_->enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    reserved_ = s;
+    reserved_position_ = position;
+    reserved_size_ = size;
+    return &data(s)[header_size];
+}
+
+bool MpmcMemory::commit(DataType type, unsigned int size) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is already closed or nothing is reserved
+    if (fd_ == -1 || reserved_ == nullptr)
+        return false;
+
+    // Slot is already claimed and has to be published, so size errors become invalid messages
+    const auto valid = size <= reserved_size_;
+    const auto id = control_->next_id.fetch_add(1, std::memory_order_relaxed);
+    DataHeader header(id, valid ? type : DataType::INVALID, valid ? size : 0, timestamp_);
+
+    // Serialize header in front of the body
+    header.serialize(data(reserved_), header_size);
+
+    // Publish slot and only wake up readers if any is sleeping
+    reserved_->sequence.store(reserved_position_ + 1, std::memory_order_seq_cst);
+    reserved_ = nullptr;
+
+    if (control_->readers_waiting.load(std::memory_order_seq_cst) > 0) {
+        control_->data_signal.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(&control_->data_signal, INT_MAX);
+    }
+
+    return valid;
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> MpmcMemory::peek() {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is open
+    if (fd_ == -1)
+        return CommunicationError::CONNECTION_CLOSED;
+
+    // Claim a filled slot unless one is still peeked
+    if (peeked_ == nullptr) {
+        Slot *s;
+        auto position = control_->dequeue_position.load(std::memory_order_relaxed);
+        while (true) {
+            s = slot(position);
+            const auto sequence = s->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int32_t>(sequence - (position + 1));
+
+            if (diff == 0) {
+                // Slot is filled, try to claim it
+                if (control_->dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                // Queue is empty
+                return CommunicationError::NO_DATA_AVAILABLE;
+            } else {
+                // Another reader claimed the slot
+                position = control_->dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+
+        peeked_ = s;
+        peeked_position_ = position;
+    }
+
+    // Deserialize header directly from the slot
+    const auto buffer = data(peeked_);
+    const auto optional = DataHeader::deserialize(buffer, header_size);
+    if (!optional || !optional->is_valid() || optional->get_body_size() > BUFFER_SIZE - header_size) {
+        release();
+        return CommunicationError::INVALID_HEADER;
+    }
+
+    return std::make_tuple(*optional, &buffer[header_size]);
+}
+
+void MpmcMemory::release() {
+    // Check if memory is open and a slot was peeked
+    if (fd_ == -1 || peeked_ == nullptr)
+        return;
+
+    // Release slot for the writer of the next round and only wake up writers if any is sleeping
+    peeked_->sequence.store(peeked_position_ + TOTAL_AMOUNT, std::memory_order_seq_cst);
+    peeked_ = nullptr;
+
+    if (control_->writers_waiting.load(std::memory_order_seq_cst) > 0) {
+        control_->space_signal.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(&control_->space_signal, INT_MAX);
+    }
+}
+
+}
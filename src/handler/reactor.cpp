@@ -0,0 +1,258 @@
+#include "handler/reactor.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+
+extern "C" {
+#include <sys/eventfd.h>
+#include <unistd.h>
+}
+
+namespace ipc {
+
+Reactor::~Reactor() {
+    // Stop bridges and close epoll if open
+    if (efd_ != -1) {
+        Reactor::close();
+    }
+}
+
+bool Reactor::open() {
+    // Check if reactor is already open
+    if (efd_ != -1)
+        return true;
+
+    efd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (efd_ == -1) {
+        perror("Reactor::open (epoll_create1)");
+        return false;
+    }
+
+    return true;
+}
+
+bool Reactor::close() {
+    // Check if reactor is already closed
+    if (efd_ == -1)
+        return false;
+
+    // Stop all bridges, descriptors are removed together with epoll
+    for (const auto &entry: entries_)
+        stop_bridge(*entry);
+    entries_.clear();
+    ready_.clear();
+
+    ::close(efd_);
+    efd_ = -1;
+
+    return true;
+}
+
+bool Reactor::add(ICommunicationHandler &handler) {
+    // Check if reactor is open and handler is not registered yet
+    if (efd_ == -1)
+        return false;
+
+    if (std::any_of(entries_.begin(), entries_.end(), [&](const auto &e) { return e->handler == &handler; }))
+        return false;
+
+    auto entry = std::make_unique<Entry>();
+    entry->handler = &handler;
+
+    // Handlers without descriptor are awaited by a bridge
+    const auto success = handler.descriptor() == -1 ? start_bridge(*entry) : update(*entry);
+    if (!success)
+        return false;
+
+    entries_.push_back(std::move(entry));
+    return true;
+}
+
+bool Reactor::remove(ICommunicationHandler &handler) {
+    const auto it = std::find_if(entries_.begin(), entries_.end(),
+                                 [&](const auto &e) { return e->handler == &handler; });
+    if (it == entries_.end())
+        return false;
+
+    // Descriptor may already be closed together with the handler
+    auto &entry = **it;
+    if (entry.bridge)
+        stop_bridge(entry);
+    else if (entry.fd != -1 && epoll_ctl(efd_, EPOLL_CTL_DEL, entry.fd, nullptr) == -1 && errno != ENOENT && errno != EBADF)
+        perror("Reactor::remove (epoll_ctl)");
+
+    ready_.erase(std::remove(ready_.begin(), ready_.end(), &handler), ready_.end());
+    entries_.erase(it);
+    return true;
+}
+
+void Reactor::release(Entry &entry) const {
+    if (entry.fd == -1 || entry.handler->descriptor() == entry.fd)
+        return;
+
+    // Remove the old descriptor, which may already be closed
+    if (epoll_ctl(efd_, EPOLL_CTL_DEL, entry.fd, nullptr) == -1 && errno != ENOENT && errno != EBADF)
+        perror("Reactor::release (epoll_ctl)");
+    entry.fd = -1;
+}
+
+bool Reactor::update(Entry &entry) {
+    release(entry);
+
+    const auto fd = entry.handler->descriptor();
+    entry.fd = fd;
+    if (fd == -1)
+        return false;
+
+    // The same number may belong to a reopened descriptor, which closing dropped from epoll, so always register it
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = &entry;
+    if (epoll_ctl(efd_, EPOLL_CTL_MOD, fd, &event) == -1
+        && (errno != ENOENT || epoll_ctl(efd_, EPOLL_CTL_ADD, fd, &event) == -1)) {
+        perror("Reactor::update (epoll_ctl)");
+        entry.fd = -1;
+        return false;
+    }
+
+    return true;
+}
+
+bool Reactor::start_bridge(Entry &entry) {
+    auto bridge = std::make_unique<Bridge>();
+
+    // Create doorbell, which is rung by the bridge and polled by the reactor
+    bridge->doorbell = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (bridge->doorbell == -1) {
+        perror("Reactor::start_bridge (eventfd)");
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = &entry;
+    if (epoll_ctl(efd_, EPOLL_CTL_ADD, bridge->doorbell, &event) == -1) {
+        perror("Reactor::start_bridge (epoll_ctl)");
+        ::close(bridge->doorbell);
+        return false;
+    }
+
+    entry.fd = bridge->doorbell;
+    bridge->thread = std::thread(run_bridge, std::ref(*entry.handler), std::ref(*bridge));
+    entry.bridge = std::move(bridge);
+
+    return true;
+}
+
+void Reactor::stop_bridge(Entry &entry) {
+    if (!entry.bridge)
+        return;
+
+    // Wake the bridge and wait until its pending await_data returns
+    {
+        const std::lock_guard lock(entry.bridge->mutex);
+        entry.bridge->stop = true;
+    }
+    entry.bridge->condition.notify_one();
+    entry.bridge->thread.join();
+
+    ::close(entry.bridge->doorbell);
+    entry.bridge.reset();
+    entry.fd = -1;
+}
+
+void Reactor::run_bridge(ICommunicationHandler &handler, Bridge &bridge) {
+    std::unique_lock lock(bridge.mutex);
+
+    while (true) {
+        // Wait until the reactor waits for the handler again
+        bridge.condition.wait(lock, [&] { return bridge.armed || bridge.stop; });
+        if (bridge.stop)
+            return;
+
+        // The handler is only used by this thread while armed
+        lock.unlock();
+        auto available = false;
+        while (!available) {
+            available = handler.await_data();
+
+            const std::lock_guard guard(bridge.mutex);
+            if (bridge.stop)
+                return;
+        }
+        lock.lock();
+
+        // Disarm before ringing, so the handler is passed to the reader
+        bridge.armed = false;
+        const std::uint64_t value = 1;
+        if (::write(bridge.doorbell, &value, sizeof(value)) == -1)
+            perror("Reactor::run_bridge (write)");
+    }
+}
+
+int Reactor::wait(int timeout) {
+    // Check if reactor is open
+    if (efd_ == -1)
+        return -1;
+
+    // Drop stale descriptors first, as another handler may have reopened the same number
+    for (const auto &entry: entries_) {
+        if (!entry->bridge)
+            release(*entry);
+    }
+
+    // Handlers reported last time were drained, so their bridges may await them again
+    for (const auto &entry: entries_) {
+        if (!entry->bridge)
+            update(*entry);
+        else if (!entry->bridge->armed) {
+            {
+                const std::lock_guard lock(entry->bridge->mutex);
+                entry->bridge->armed = true;
+            }
+            entry->bridge->condition.notify_one();
+        }
+    }
+    ready_.clear();
+
+    const auto res = epoll_wait(efd_, events_.data(), MAX_EVENTS, timeout);
+    if (res == -1) {
+        if (errno == EINTR)
+            return 0;
+
+        perror("Reactor::wait (epoll_wait)");
+        return -1;
+    }
+
+    for (int i = 0; i < res; ++i) {
+        auto &entry = *static_cast<Entry *>(events_[i].data.ptr);
+
+        if (entry.bridge) {
+            // Reset the doorbell, the bridge stays disarmed until the next wait
+            std::uint64_t value;
+            if (::read(entry.bridge->doorbell, &value, sizeof(value)) == -1 && errno != EAGAIN)
+                perror("Reactor::wait (read)");
+
+            ready_.push_back(entry.handler);
+            continue;
+        }
+
+        // Readiness only wakes the handler, it may accept clients or consume control messages first without blocking
+        auto &handler = *entry.handler;
+        const auto policy = handler.wait_policy();
+        const auto spin_count = handler.spin_count();
+
+        handler.set_wait_policy(WaitPolicy::POLL);
+        const auto available = handler.await_data();
+        handler.set_wait_policy(policy, spin_count);
+
+        if (available)
+            ready_.push_back(&handler);
+    }
+
+    return static_cast<int>(ready_.size());
+}
+
+}
@@ -0,0 +1,377 @@
+#include "handler/seqpacket_socket.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+extern "C" {
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+}
+
+#include "utility.hpp"
+
+namespace ipc {
+
+SeqPacketSocket::SeqPacketSocket(std::string path, bool server)
+        : path_(std::move(path)), server_(server) {}
+
+SeqPacketSocket::~SeqPacketSocket() {
+    // Close socket if open
+    if (sfd_ != -1) {
+        SeqPacketSocket::close();
+    }
+}
+
+bool SeqPacketSocket::open() {
+    // Check if socket is already open
+    if (sfd_ != -1)
+        return true;
+
+    // Build address for communication
+    address_ = {};
+    address_.sun_family = AF_UNIX;
+    strncpy(address_.sun_path, path_.c_str(), sizeof(address_.sun_path) - 1);
+
+    // Create server or client
+    if (server_ ? !create_server() : !create_client()) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool SeqPacketSocket::create_server() {
+    // Open socket
+    sfd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK, 0);
+    if (sfd_ == -1) {
+        perror("SeqPacketSocket::create_server (socket)");
+        return false;
+    }
+
+    // Remove old socket files
+    remove(address_.sun_path);
+
+    // Bind socket for listing
+    if (bind(sfd_, reinterpret_cast<const sockaddr *>(&address_), sizeof(sockaddr_un)) == -1) {
+        perror("SeqPacketSocket::create_server (bind)");
+        return false;
+    }
+
+    // Listen for incoming socket connections
+    if (listen(sfd_, BACKLOG) == -1) {
+        perror("SeqPacketSocket::create_server (listen)");
+        return false;
+    }
+
+    return true;
+}
+
+bool SeqPacketSocket::create_client() {
+    // Open socket
+    sfd_ = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (sfd_ == -1) {
+        perror("SeqPacketSocket::create_client (socket)");
+        return false;
+    }
+
+    // Connect to server
+    if (connect(sfd_, reinterpret_cast<const sockaddr *>(&address_), sizeof(sockaddr_un)) == -1) {
+        perror("SeqPacketSocket::create_client (connect)");
+        return false;
+    }
+
+    return true;
+}
+
+bool SeqPacketSocket::close() {
+    // Check if socket is already closed
+    if (sfd_ == -1)
+        return false;
+
+    // Close socket
+    ::close(sfd_);
+
+    if (cfd_ != -1)
+        ::close(cfd_);
+
+    // Remove file only for the server
+    if (server_)
+        remove(address_.sun_path);
+
+    sfd_ = -1;
+    cfd_ = -1;
+
+    return true;
+}
+
+bool SeqPacketSocket::is_open() const {
+    return sfd_ != -1;
+}
+
+bool SeqPacketSocket::accept() {
+    // Check if socket is open
+    if (sfd_ == -1)
+        return false;
+
+    // Close old client socket
+    if (cfd_ != -1) {
+        ::close(cfd_);
+        cfd_ = -1;
+    }
+
+    // Check if new clients are available
+    auto res = poll(sfd_, accept_time());
+    if (res == -1) {
+        perror("SeqPacketSocket::accept (poll)");
+        return false;
+    }
+
+    // No new clients available
+    if (res == 0)
+        return false;
+
+    // Accept new client
+    res = ::accept4(sfd_, nullptr, nullptr, SOCK_NONBLOCK);
+    if (res == -1) {
+        perror("SeqPacketSocket::accept (accept)");
+        return false;
+    }
+
+    cfd_ = res;
+    return true;
+}
+
+bool SeqPacketSocket::await_data() {
+    // Check if socket is open
+    if (cfd_ == -1) {
+        if (!accept())
+            return false;
+    }
+
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return poll(cfd_, 0) > 0; }))
+        return true;
+
+    if (!may_block())
+        return false;
+
+    // Poll events and block until one is available
+    const auto res = poll(cfd_, WAIT_TIME);
+    if (res == -1)
+        perror("SeqPacketSocket::await_data (poll)");
+
+    return res > 0;
+}
+
+bool SeqPacketSocket::has_data() const {
+    // Check if socket is open
+    if (cfd_ == -1)
+        return false;
+
+    // Poll events and block for 1ms
+    const auto res = poll(cfd_, 1);
+    if (res == -1)
+        perror("SeqPacketSocket::has_data (poll)");
+
+    return res > 0;
+}
+
+int SeqPacketSocket::descriptor() const {
+    // The listening socket until a client is accepted
+    return cfd_ != -1 ? cfd_ : sfd_;
+}
+
+bool SeqPacketSocket::write(const IDataObject &obj) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if socket is open
+    if (sfd_ == -1)
+        return false;
+
+    // Split objects which don't fit into a single packet, fragments are already sized to fit
+    if (obj.get_type() != DataType::FRAGMENT) {
+        const auto fragments = fragmenter_.split(obj, PACKET_SIZE - header_size);
+        if (fragments != 0)
+            return fragments != -1 && fragmenter_.write(*this);
+    }
+
+    // Describe body as parts, only small parts are serialized behind the header
+    // Fragments reference their offset and every part of the whole message, so they need one more part
+    const auto timestamp = get_timestamp();
+    std::array<iovec, MAX_PARTS + 2> vectors{};
+    const auto parts = obj.serialize_parts(&buffer_[header_size], BUFFER_SIZE - header_size,
+                                           &vectors[1], vectors.size() - 1);
+    if (parts == -1)
+        return false;
+
+    // Every packet has to fit into the buffer of the reader
+    const auto size = total_size(&vectors[1], parts);
+    if (size > PACKET_SIZE - header_size)
+        return false;
+
+    last_id_++;
+    DataHeader header(last_id_, obj.get_type(), size, timestamp);
+
+    // Serialize header
+    header.serialize(buffer_.data(), header_size);
+    vectors[0] = {buffer_.data(), header_size};
+
+    // Write header and body as a single packet, the kernel never splits it
+    msghdr message{};
+    message.msg_iov = vectors.data();
+    message.msg_iovlen = parts + 1;
+
+    ssize_t res;
+    do {
+        res = sendmsg(sfd_, &message, 0);
+    } while (res == -1 && errno == EINTR);
+
+    if (res == -1)
+        perror("SeqPacketSocket::write (sendmsg)");
+
+    return res != -1;
+}
+
+unsigned int SeqPacketSocket::write_batch(const std::vector<const IDataObject *> &objects) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if socket is open
+    if (sfd_ == -1)
+        return 0;
+
+    unsigned int written = 0;
+    while (written < objects.size()) {
+        const auto timestamp = get_timestamp();
+
+        // Serialize up to a full batch into separate packets
+        unsigned int amount = 0;
+        auto failed = false;
+        auto oversized = false;
+        while (amount < BATCH_SIZE && written + amount < objects.size()) {
+            const auto obj = objects[written + amount];
+            const auto buffer = &send_buffer_[amount * BUFFER_SIZE];
+            const auto vectors = &send_vectors_[amount * MAX_PARTS];
+
+            const auto parts = obj->serialize_parts(&buffer[header_size], BUFFER_SIZE - header_size,
+                                                    &vectors[1], MAX_PARTS - 1);
+            if (parts == -1) {
+                failed = true;
+                break;
+            }
+
+            // Objects which don't fit are written as fragments after the batch
+            const auto size = total_size(&vectors[1], parts);
+            if (size > PACKET_SIZE - header_size) {
+                oversized = true;
+                break;
+            }
+
+            last_id_++;
+            DataHeader header(last_id_, obj->get_type(), size, timestamp);
+            header.serialize(buffer, header_size);
+            vectors[0] = {buffer, header_size};
+
+            send_messages_[amount] = {};
+            send_messages_[amount].msg_hdr.msg_iov = vectors;
+            send_messages_[amount].msg_hdr.msg_iovlen = parts + 1;
+            amount++;
+        }
+
+        // Send all packets of the batch with a single call
+        unsigned int sent = 0;
+        while (sent < amount) {
+            const auto res = sendmmsg(sfd_, &send_messages_[sent], amount - sent, 0);
+            if (res == -1) {
+                if (errno == EINTR)
+                    continue;
+
+                perror("SeqPacketSocket::write_batch (sendmmsg)");
+                return written + sent;
+            }
+
+            sent += res;
+        }
+
+        written += amount;
+        if (failed || (oversized && !write(*objects[written])))
+            break;
+
+        if (oversized)
+            written++;
+    }
+
+    return written;
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> SeqPacketSocket::receive() {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if socket is open
+    if (cfd_ == -1)
+        return CommunicationError::CONNECTION_CLOSED;
+
+    // Receive exactly one packet, its real length is returned even if it didn't fit
+    const auto result = recv(cfd_, receive_buffer_.data(), receive_buffer_.size(), MSG_TRUNC);
+    if (result == -1) {
+        if (errno == EAGAIN)
+            return CommunicationError::NO_DATA_AVAILABLE;
+
+        perror("SeqPacketSocket::receive (recv)");
+        return CommunicationError::READ_ERROR;
+    }
+
+    // The writer closed the connection or died
+    if (result == 0)
+        return CommunicationError::CONNECTION_CLOSED;
+
+    if (static_cast<std::size_t>(result) > receive_buffer_.size())
+        return CommunicationError::INVALID_DATA;
+
+    // Deserialize header
+    const auto optional = DataHeader::deserialize(receive_buffer_.data(), result);
+    if (!optional)
+        return CommunicationError::INVALID_HEADER;
+
+    const auto header = *optional;
+    if (header.get_body_size() != result - header_size)
+        return CommunicationError::INVALID_HEADER;
+
+    return std::make_tuple(header, &receive_buffer_[header_size]);
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> SeqPacketSocket::read() {
+    // Receive message into buffer, fragments are reassembled on the way
+    const auto message = reassembler_.receive([this] { return receive(); });
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObject>(body)) {
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> SeqPacketSocket::read_view() {
+    // Receive message into buffer, the view is valid until the next read or fragment
+    const auto message = reassembler_.receive([this] { return receive(); });
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    const auto body = deserialize_data_object_view(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObjectView>(body)) {
+        return std::make_tuple(header, std::get<DataObjectView>(body));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+}
@@ -92,6 +92,13 @@ bool SharedFile::await_data() {
     if (!file_.is_open())
         return false;
 
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return has_data(); }))
+        return true;
+
+    if (!may_block())
+        return false;
+
 #if WAIT_TIME == -1
     // Wait for data
     const auto res = sem_wait(reader_);
@@ -143,6 +150,11 @@ bool SharedFile::write(const IDataObject &obj) {
     if (!file_.is_open())
         return false;
 
+    // Split objects which don't fit into a single slot
+    const auto fragments = fragmenter_.split(obj, BUFFER_SIZE - header_size);
+    if (fragments != 0)
+        return fragments != -1 && fragmenter_.write(*this);
+
     // Serialize body
     const auto timestamp = get_timestamp();
     const auto size = obj.serialize(&buffer_[header_size], BUFFER_SIZE - header_size);
@@ -188,7 +200,7 @@ bool SharedFile::write(const IDataObject &obj) {
     return true;
 }
 
-std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> SharedFile::read() {
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> SharedFile::receive() {
     constexpr auto header_size = sizeof(DataHeader);
 
     // Check if file is open
@@ -202,7 +214,7 @@ std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> SharedFile:
             return CommunicationError::NO_DATA_AVAILABLE;
         }
 
-        perror("SharedFile::read (sem_trywait)");
+        perror("SharedFile::receive (sem_trywait)");
         return CommunicationError::READ_ERROR;
     }
 
@@ -212,7 +224,7 @@ std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> SharedFile:
     // Move read pointer to correct location
     file_.seekg(offset_ * BUFFER_SIZE, std::ios::beg);
     if (file_.fail()) {
-        perror("SharedFile::read (seekg)");
+        perror("SharedFile::receive (seekg)");
         sem_post(reader_);
         return CommunicationError::READ_ERROR;
     }
@@ -221,7 +233,7 @@ std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> SharedFile:
     const auto data = reinterpret_cast<char *>(buffer_.data());
     file_.read(data, BUFFER_SIZE);
     if (file_.fail() && !file_.eof()) {
-        perror("SharedFile::read (read)");
+        perror("SharedFile::receive (read)");
         sem_post(reader_);
         return CommunicationError::READ_ERROR;
     }
@@ -237,11 +249,36 @@ std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> SharedFile:
     const auto header = *optional;
     assert(header.get_body_size() <= BUFFER_SIZE - header_size);
 
-    const auto body = deserialize_data_object(header.get_type(), &buffer_[header_size], header.get_body_size());
+    return std::make_tuple(header, &buffer_[header_size]);
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> SharedFile::read() {
+    // Receive message into buffer, fragments are reassembled on the way
+    const auto message = reassembler_.receive([this] { return receive(); });
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
 
     if (std::holds_alternative<DataObject>(body)) {
-        const auto obj = std::get<DataObject>(body);
-        return std::make_tuple(header, obj);
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> SharedFile::read_view() {
+    // Receive message into buffer, the view is valid until the next read or fragment
+    const auto message = reassembler_.receive([this] { return receive(); });
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    const auto body = deserialize_data_object_view(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObjectView>(body)) {
+        return std::make_tuple(header, std::get<DataObjectView>(body));
     } else {
         return std::get<CommunicationError>(body);
     }
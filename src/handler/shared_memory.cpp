@@ -1,7 +1,7 @@
 #include "handler/shared_memory.hpp"
 
-#include <cassert>
 #include <cstring>
+#include <optional>
 #include <utility>
 
 extern "C" {
@@ -68,8 +68,16 @@ bool SharedMemory::open() {
         }
     }
 
-    // Allocate memory
-    auto addr = mmap(nullptr, TOTAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    // Ring must be mapped on page boundaries to mirror it
+    const auto page_size = sysconf(_SC_PAGESIZE);
+    if (CONTROL_SIZE % page_size != 0 || RING_SIZE % page_size != 0) {
+        fprintf(stderr, "SharedMemory::open (Ring is not page aligned)\n");
+        close();
+        return false;
+    }
+
+    // Reserve address space for the control block and the ring twice
+    auto addr = mmap(nullptr, MAPPED_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
     if (addr == MAP_FAILED) {
         perror("SharedMemory::open (mmap)");
         close();
@@ -78,6 +86,25 @@ bool SharedMemory::open() {
 
     address_ = static_cast<std::byte *>(addr);
 
+    // Allocate memory for the control block and the ring
+    addr = mmap(address_, TOTAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        perror("SharedMemory::open (mmap)");
+        close();
+        return false;
+    }
+
+    // Map the ring again directly behind itself, so messages never wrap around
+    addr = mmap(&address_[TOTAL_SIZE], RING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_, CONTROL_SIZE);
+    if (addr == MAP_FAILED) {
+        perror("SharedMemory::open (mmap)");
+        close();
+        return false;
+    }
+
+    control_ = reinterpret_cast<Control *>(address_);
+    ring_ = &address_[CONTROL_SIZE];
+
     std::string prefix(name_.substr(name_.rfind('/') + 1) + "_sem");
 
     if (server_) {
@@ -93,7 +120,7 @@ bool SharedMemory::open() {
         return false;
     }
 
-    writer_ = sem_open((prefix + "w").c_str(), flag, 0660, TOTAL_AMOUNT);
+    writer_ = sem_open((prefix + "w").c_str(), flag, 0660, 0);
     if (writer_ == SEM_FAILED) {
         perror("SharedMemory::open (sem_open)");
         close();
@@ -108,8 +135,11 @@ bool SharedMemory::close() {
     if (fd_ == -1)
         return false;
 
-    munmap(address_, TOTAL_SIZE);
+    if (address_ != nullptr)
+        munmap(address_, MAPPED_SIZE);
     address_ = nullptr;
+    control_ = nullptr;
+    ring_ = nullptr;
 
     ::close(fd_);
     fd_ = -1;
@@ -141,6 +171,24 @@ bool SharedMemory::await_data() {
     if (fd_ == -1)
         return false;
 
+    // Check if data is available without any syscall
+    if (has_data())
+        return true;
+
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return has_data(); }))
+        return true;
+
+    if (!may_block())
+        return false;
+
+    // Announce waiting and check again, so the writer can't miss it
+    control_->reader_waiting.store(1, std::memory_order_seq_cst);
+    if (control_->write_position.load(std::memory_order_seq_cst) != offset_) {
+        control_->reader_waiting.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
 #if WAIT_TIME == -1
     // Wait for data
     int res = sem_wait(reader_);
@@ -162,13 +210,14 @@ bool SharedMemory::await_data() {
         if (errno != ETIMEDOUT)
             perror("SharedMemory::await_data (sem_timedwait)");
 
+        control_->reader_waiting.store(0, std::memory_order_relaxed);
         return false;
     }
 #endif
 
-    // Increment semaphore (because this method just checks if data is available)
-    sem_post(reader_);
-    return true;
+    // Semaphore may have been posted for data which was already read
+    control_->reader_waiting.store(0, std::memory_order_relaxed);
+    return has_data();
 }
 
 bool SharedMemory::has_data() const {
@@ -176,89 +225,279 @@ bool SharedMemory::has_data() const {
     if (fd_ == -1)
         return false;
 
-    // Check if data is available
-    int value;
-    const auto res = sem_getvalue(reader_, &value);
-    if (res == -1)
-        perror("SharedMemory::has_data (sem_getvalue)");
-
-    return res != -1 && value > 0;
+    // Check if the writer published data behind the current position
+    return control_->write_position.load(std::memory_order_acquire) != offset_;
 }
 
 bool SharedMemory::write(const IDataObject &obj) {
     constexpr auto header_size = sizeof(DataHeader);
 
-    // Check if memory is already closed
-    if (fd_ == -1)
+    // Split objects which don't fit into a single message
+    const auto fragments = fragmenter_.split(obj, BUFFER_SIZE - header_size);
+    if (fragments != 0)
+        return fragments != -1 && fragmenter_.write(*this);
+
+    // Reserve space and serialize body directly into the memory
+    const auto buffer = reserve(BUFFER_SIZE - header_size);
+    if (buffer == nullptr)
         return false;
 
-    // Serialize body
-    const auto timestamp = get_timestamp();
-    const auto size = obj.serialize(&buffer_[header_size], BUFFER_SIZE - header_size);
-    if (size == -1)
+    const auto size = obj.serialize(buffer, BUFFER_SIZE - header_size);
+    if (size == -1) {
+        reserved_ = 0;
         return false;
+    }
 
-    last_id_++;
-    DataHeader header(last_id_, obj.get_type(), size, timestamp);
+    return commit(obj.get_type(), size);
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> SharedMemory::read() {
+    // Continue after a message which is still viewed
+    release_view();
+
+    // Get message directly from memory, fragments are reassembled on the way
+    const auto message = peek_message();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
+    release();
+
+    if (std::holds_alternative<DataObject>(body)) {
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> SharedMemory::read_view() {
+    // Get view directly into the transport, it is released on the next read
+    return peek_view();
+}
+
+std::byte *SharedMemory::reserve(unsigned int size) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is already closed or message is too large
+    if (fd_ == -1 || header_size + size > RING_SIZE)
+        return nullptr;
 
-    // Serialize header
-    header.serialize(buffer_.data(), header_size);
+    timestamp_ = get_timestamp();
 
     // Wait until memory is available
-    const auto res = sem_wait(writer_);
-    if (res == -1) {
-        perror("SharedMemory::write (sem_wait)");
+    if (!wait_for_space(aligned(header_size + size)))
+        return nullptr;
+
+    // The mirrored ring keeps the message contiguous
+    reserved_ = size;
+    return &ring_[(offset_ & (RING_SIZE - 1)) + header_size];
+}
+
+bool SharedMemory::commit(DataType type, unsigned int size) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is already closed or size exceeds reservation
+    if (fd_ == -1 || size > reserved_)
         return false;
-    }
 
-    // Copy data to memory
-    std::memcpy(&address_[offset_ * BUFFER_SIZE], buffer_.data(), header_size + size);
-    offset_ = (offset_ + 1) % TOTAL_AMOUNT;
+    last_id_++;
+    DataHeader header(last_id_, type, size, timestamp_);
+
+    // Serialize header in front of the body
+    header.serialize(&ring_[offset_ & (RING_SIZE - 1)], header_size);
+    offset_ += aligned(header_size + size);
+    reserved_ = 0;
 
-    sem_post(reader_);
+    publish();
     return true;
 }
 
-std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> SharedMemory::read() {
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> SharedMemory::peek() {
     constexpr auto header_size = sizeof(DataHeader);
 
     // Check if memory is open
     if (fd_ == -1)
         return CommunicationError::CONNECTION_CLOSED;
 
-    // Wait and check if data is still available
-    const auto res = sem_trywait(reader_);
-    if (res == -1) {
-        if (errno == EAGAIN) {
+    // Check if data is available, unless the message wasn't released yet
+    if (peeked_ == 0 && write_position_ == offset_) {
+        write_position_ = control_->write_position.load(std::memory_order_acquire);
+        if (write_position_ == offset_)
             return CommunicationError::NO_DATA_AVAILABLE;
+    }
+
+    // Deserialize header directly from memory
+    const auto data = &ring_[offset_ & (RING_SIZE - 1)];
+    const auto optional = DataHeader::deserialize(data, header_size);
+    if (!optional || header_size + optional->get_body_size() > RING_SIZE) {
+        // Skip the invalid header, the size of the message is unknown
+        peeked_ = aligned(header_size);
+        release();
+        return CommunicationError::INVALID_HEADER;
+    }
+
+    peeked_ = aligned(header_size + optional->get_body_size());
+    return std::make_tuple(*optional, &data[header_size]);
+}
+
+void SharedMemory::release() {
+    // Check if memory is open and a message was peeked
+    if (fd_ == -1 || peeked_ == 0)
+        return;
+
+    offset_ += peeked_;
+    peeked_ = 0;
+
+    free_space();
+}
+
+std::variant<unsigned int, CommunicationError> SharedMemory::read_batch(
+        std::vector<std::tuple<DataHeader, DataObject>> &out, unsigned int max) {
+    // Continue after a message which is still viewed
+    release_view();
+
+    unsigned int amount = 0;
+    std::optional<CommunicationError> error{};
+
+    while (amount < max) {
+        // Get message directly from memory, fragments are reassembled on the way
+        const auto message = peek_message();
+        if (std::holds_alternative<CommunicationError>(message)) {
+            error = std::get<CommunicationError>(message);
+            break;
+        }
+
+        const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+        const auto body = deserialize_data_object_view(header.get_type(), data, header.get_body_size());
+
+        if (std::holds_alternative<DataObjectView>(body)) {
+            // Reuse the storage of existing entries
+            if (amount == out.size())
+                out.emplace_back(header, Ping());
+
+            std::get<DataHeader>(out[amount]) = header;
+            assign_data_object(std::get<DataObject>(out[amount]), std::get<DataObjectView>(body));
         }
 
-        perror("SharedMemory::read (sem_trywait)");
-        return CommunicationError::READ_ERROR;
+        // Skip message locally, memory is released once for the whole batch
+        offset_ += peeked_;
+        peeked_ = 0;
+
+        if (std::holds_alternative<CommunicationError>(body)) {
+            error = std::get<CommunicationError>(body);
+            break;
+        }
+
+        amount++;
     }
 
-    // Copy data from memory
-    std::memcpy(buffer_.data(), &address_[offset_ * BUFFER_SIZE], BUFFER_SIZE);
-    offset_ = (offset_ + 1) % TOTAL_AMOUNT;
-    sem_post(writer_);
+    free_space();
 
-    // Deserialize header
-    const auto optional = DataHeader::deserialize(buffer_.data(), header_size);
-    if (!optional)
-        return CommunicationError::INVALID_HEADER;
+    if (amount == 0 && error)
+        return *error;
 
-    const auto header = *optional;
-    assert(header.get_body_size() <= BUFFER_SIZE - header_size);
+    return amount;
+}
 
-    const auto body = deserialize_data_object(header.get_type(), &buffer_[header_size], header.get_body_size());
+unsigned int SharedMemory::write_batch(const std::vector<const IDataObject *> &objects) {
+    constexpr auto header_size = sizeof(DataHeader);
 
-    if (std::holds_alternative<DataObject>(body)) {
-        const auto obj = std::get<DataObject>(body);
-        return std::make_tuple(header, obj);
-    } else {
-        return std::get<CommunicationError>(body);
+    // Check if memory is already closed
+    if (fd_ == -1)
+        return 0;
+
+    unsigned int written = 0;
+    for (const auto obj: objects) {
+        // Objects which don't fit are written as fragments behind the batch so far
+        const auto fragments = fragmenter_.split(*obj, BUFFER_SIZE - header_size);
+        if (fragments != 0) {
+            if (fragments == -1 || !fragmenter_.write(*this))
+                break;
+
+            written++;
+            continue;
+        }
+
+        // Reserve space and serialize body directly into the memory
+        const auto buffer = reserve(BUFFER_SIZE - header_size);
+        if (buffer == nullptr)
+            break;
+
+        const auto size = obj->serialize(buffer, BUFFER_SIZE - header_size);
+        if (size == -1) {
+            reserved_ = 0;
+            break;
+        }
+
+        last_id_++;
+        DataHeader header(last_id_, obj->get_type(), size, timestamp_);
+
+        // Serialize header, the message is published together with the batch
+        header.serialize(&ring_[offset_ & (RING_SIZE - 1)], header_size);
+        offset_ += aligned(header_size + size);
+        reserved_ = 0;
+        written++;
     }
+
+    publish();
+    return written;
 }
 
+void SharedMemory::publish() {
+    // Check if there is anything new to publish
+    if (published_ == offset_)
+        return;
+
+    published_ = offset_;
+
+    // Publish messages and wake up the reader only if it is waiting
+    control_->write_position.store(offset_, std::memory_order_seq_cst);
+    if (control_->reader_waiting.load(std::memory_order_seq_cst)
+        && control_->reader_waiting.exchange(0, std::memory_order_seq_cst))
+        sem_post(reader_);
+}
+
+void SharedMemory::free_space() {
+    // Check if there is anything new to release
+    if (released_ == offset_)
+        return;
+
+    released_ = offset_;
+
+    // Release memory and wake up the writer only if it is waiting
+    control_->read_position.store(offset_, std::memory_order_seq_cst);
+    if (control_->writer_waiting.load(std::memory_order_seq_cst)
+        && control_->writer_waiting.exchange(0, std::memory_order_seq_cst))
+        sem_post(writer_);
+}
+
+bool SharedMemory::wait_for_space(std::uint32_t size) {
+    while (offset_ + size - read_position_ > RING_SIZE) {
+        // Messages of a batch must be visible, otherwise the reader can't free any space
+        publish();
+
+        read_position_ = control_->read_position.load(std::memory_order_acquire);
+        if (offset_ + size - read_position_ <= RING_SIZE)
+            break;
+
+        // Announce waiting and check again, so the reader can't miss it
+        control_->writer_waiting.store(1, std::memory_order_seq_cst);
+        read_position_ = control_->read_position.load(std::memory_order_seq_cst);
+        if (offset_ + size - read_position_ <= RING_SIZE) {
+            control_->writer_waiting.store(0, std::memory_order_relaxed);
+            break;
+        }
+
+        // Wait until memory is released
+        const auto res = sem_wait(writer_);
+        if (res == -1) {
+            perror("SharedMemory::wait_for_space (sem_wait)");
+            return false;
+        }
+    }
+
+    return true;
+}
 
 }
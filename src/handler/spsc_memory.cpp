@@ -0,0 +1,354 @@
+#include "handler/spsc_memory.hpp"
+
+#include <cerrno>
+#include <utility>
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+#include "utility.hpp"
+
+namespace ipc {
+
+SpscMemory::SpscMemory(std::string name, bool server, bool file, std::string doorbell)
+        : name_(std::move(name)), server_(server), file_(file), doorbell_path_(std::move(doorbell)) {}
+
+SpscMemory::~SpscMemory() {
+    if (fd_ != -1) {
+        SpscMemory::close();
+    }
+}
+
+bool SpscMemory::open() {
+    // Check if memory is already open
+    if (fd_ != -1)
+        return true;
+
+    if (file_) {
+        if (server_) {
+            // Create memory
+            remove(name_.c_str());
+            fd_ = ::open(name_.c_str(), O_RDWR | O_CREAT, 0660);
+        } else {
+            // Open memory
+            fd_ = ::open(name_.c_str(), O_RDWR);
+        }
+
+        if (fd_ == -1) {
+            perror("SpscMemory::open (open)");
+            return false;
+        }
+    } else {
+        if (server_) {
+            // Create memory
+            shm_unlink(name_.c_str());
+            fd_ = shm_open(name_.c_str(), O_RDWR | O_CREAT, 0660);
+        } else {
+            // Open memory
+            fd_ = shm_open(name_.c_str(), O_RDWR, 0660);
+        }
+
+        if (fd_ == -1) {
+            perror("SpscMemory::open (shm_open)");
+            return false;
+        }
+    }
+
+    if (server_) {
+        // Resize memory (new memory is zeroed, so the control block starts empty)
+        if (ftruncate(fd_, TOTAL_SIZE) == -1) {
+            perror("SpscMemory::open (ftruncate)");
+            close();
+            return false;
+        }
+    }
+
+    // Allocate memory
+    auto addr = mmap(nullptr, TOTAL_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        perror("SpscMemory::open (mmap)");
+        close();
+        return false;
+    }
+
+    address_ = static_cast<std::byte *>(addr);
+    control_ = reinterpret_cast<Control *>(address_);
+
+    // Continue at the current position of the ring
+    head_ = cached_head_ = control_->head.load(std::memory_order_acquire);
+    tail_ = cached_tail_ = control_->tail.load(std::memory_order_acquire);
+
+    // The consumer creates the doorbell and passes it to the producer
+    if (!doorbell_path_.empty()) {
+        doorbell_ = std::make_unique<EventFd>(doorbell_path_, server_);
+        if (!doorbell_->open()) {
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool SpscMemory::close() {
+    // Check if memory is already closed
+    if (fd_ == -1)
+        return false;
+
+    doorbell_.reset();
+
+    if (address_ != nullptr)
+        munmap(address_, TOTAL_SIZE);
+    address_ = nullptr;
+    control_ = nullptr;
+
+    ::close(fd_);
+    fd_ = -1;
+
+    if (server_) {
+        if (file_) {
+            remove(name_.c_str());
+        } else {
+            shm_unlink(name_.c_str());
+        }
+    }
+
+    return true;
+}
+
+bool SpscMemory::is_open() const {
+    return fd_ != -1;
+}
+
+bool SpscMemory::await_data() {
+    // Check if memory is already closed
+    if (fd_ == -1)
+        return false;
+
+    // Check if data is available without any syscall
+    cached_head_ = control_->head.load(std::memory_order_acquire);
+    if (cached_head_ != tail_)
+        return true;
+
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return (cached_head_ = control_->head.load(std::memory_order_acquire)) != tail_; }))
+        return true;
+
+    if (doorbell_)
+        return await_doorbell();
+
+    if (!may_block())
+        return false;
+
+    // Announce sleep and check again, so the producer can't miss it
+    control_->reader_waiting.store(1, std::memory_order_seq_cst);
+    cached_head_ = control_->head.load(std::memory_order_seq_cst);
+
+    if (cached_head_ == tail_) {
+        // Wait for data
+        const auto res = futex_wait(&control_->head, tail_, WAIT_TIME);
+        if (res == -1 && errno != ETIMEDOUT && errno != EAGAIN && errno != EINTR)
+            perror("SpscMemory::await_data (futex_wait)");
+
+        cached_head_ = control_->head.load(std::memory_order_acquire);
+    }
+
+    control_->reader_waiting.store(0, std::memory_order_relaxed);
+    return cached_head_ != tail_;
+}
+
+bool SpscMemory::has_data() const {
+    // Check if memory is already closed
+    if (fd_ == -1)
+        return false;
+
+    // Check if data is available
+    return control_->head.load(std::memory_order_acquire) != tail_;
+}
+
+int SpscMemory::descriptor() const {
+    // Only the consumer waits for the doorbell
+    return doorbell_ && server_ ? doorbell_->descriptor() : -1;
+}
+
+bool SpscMemory::arm_doorbell() {
+    // The producer disarms the doorbell when ringing it, so it is only reset once per idle period
+    if (!control_->reader_waiting.load(std::memory_order_seq_cst)) {
+        doorbell_->take();
+        control_->reader_waiting.store(1, std::memory_order_seq_cst);
+    }
+
+    // Check again, so the producer can't miss it
+    cached_head_ = control_->head.load(std::memory_order_seq_cst);
+    return cached_head_ != tail_;
+}
+
+bool SpscMemory::await_doorbell() {
+    if (arm_doorbell())
+        return true;
+
+    // The doorbell also serves connecting producers, so it is checked even if this handler must not block
+    doorbell_->set_wait_policy(may_block() ? WaitPolicy::BLOCK : WaitPolicy::POLL);
+    doorbell_->await_data();
+
+    cached_head_ = control_->head.load(std::memory_order_acquire);
+    return cached_head_ != tail_;
+}
+
+bool SpscMemory::write(const IDataObject &obj) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Split objects which don't fit into a single slot
+    const auto fragments = fragmenter_.split(obj, BUFFER_SIZE - header_size);
+    if (fragments != 0)
+        return fragments != -1 && fragmenter_.write(*this);
+
+    // Reserve slot and serialize body directly into it
+    const auto buffer = reserve(BUFFER_SIZE - header_size);
+    if (buffer == nullptr)
+        return false;
+
+    const auto size = obj.serialize(buffer, BUFFER_SIZE - header_size);
+    if (size == -1) {
+        reserved_ = 0;
+        return false;
+    }
+
+    return commit(obj.get_type(), size);
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> SpscMemory::read() {
+    // Continue after a message which is still viewed
+    release_view();
+
+    // Get message directly from the slot, fragments are reassembled on the way
+    const auto message = peek_message();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
+    release();
+
+    if (std::holds_alternative<DataObject>(body)) {
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> SpscMemory::read_view() {
+    // Get view directly into the transport, it is released on the next read
+    return peek_view();
+}
+
+std::byte *SpscMemory::reserve(unsigned int size) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is already closed or message is too large
+    if (fd_ == -1 || header_size + size > BUFFER_SIZE)
+        return nullptr;
+
+    timestamp_ = get_timestamp();
+
+    // Wait until a slot is available
+    while (head_ - cached_tail_ >= TOTAL_AMOUNT) {
+        cached_tail_ = control_->tail.load(std::memory_order_acquire);
+        if (head_ - cached_tail_ < TOTAL_AMOUNT)
+            break;
+
+        // Announce sleep and check again, so the consumer can't miss it
+        control_->writer_waiting.store(1, std::memory_order_seq_cst);
+        cached_tail_ = control_->tail.load(std::memory_order_seq_cst);
+
+        if (head_ - cached_tail_ >= TOTAL_AMOUNT) {
+            const auto res = futex_wait(&control_->tail, cached_tail_, WAIT_TIME);
+            if (res == -1 && errno != ETIMEDOUT && errno != EAGAIN && errno != EINTR) {
+                perror("SpscMemory::reserve (futex_wait)");
+                control_->writer_waiting.store(0, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+
+        control_->writer_waiting.store(0, std::memory_order_relaxed);
+    }
+
+    reserved_ = size;
+    return &slot(head_)[header_size];
+}
+
+bool SpscMemory::commit(DataType type, unsigned int size) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is already closed or size exceeds reservation
+    if (fd_ == -1 || size > reserved_)
+        return false;
+
+    last_id_++;
+    DataHeader header(last_id_, type, size, timestamp_);
+
+    // Serialize header in front of the body
+    header.serialize(slot(head_), header_size);
+    reserved_ = 0;
+
+    // Publish slot and only wake up the consumer if it is sleeping
+    head_++;
+    control_->head.store(head_, std::memory_order_seq_cst);
+    if (doorbell_) {
+        if (control_->reader_waiting.exchange(0, std::memory_order_seq_cst))
+            doorbell_->notify();
+    } else if (control_->reader_waiting.load(std::memory_order_seq_cst)) {
+        futex_wake(&control_->head, 1);
+    }
+
+    return true;
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> SpscMemory::peek() {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if memory is open
+    if (fd_ == -1)
+        return CommunicationError::CONNECTION_CLOSED;
+
+    // Check if data is available, only touch the producer cache line if required
+    if (cached_head_ == tail_) {
+        cached_head_ = control_->head.load(std::memory_order_acquire);
+
+        // Waiting through the reactor skips await_data, so the doorbell is armed once the ring is drained
+        if (cached_head_ == tail_ && (!doorbell_ || !arm_doorbell()))
+            return CommunicationError::NO_DATA_AVAILABLE;
+    }
+
+    // Deserialize header directly from the slot
+    const auto buffer = slot(tail_);
+    const auto optional = DataHeader::deserialize(buffer, header_size);
+    peeked_ = true;
+
+    if (!optional || optional->get_body_size() > BUFFER_SIZE - header_size) {
+        release();
+        return CommunicationError::INVALID_HEADER;
+    }
+
+    return std::make_tuple(*optional, &buffer[header_size]);
+}
+
+void SpscMemory::release() {
+    // Check if memory is open and a message was peeked
+    if (fd_ == -1 || !peeked_)
+        return;
+
+    peeked_ = false;
+
+    // Release slot and only wake up the producer if it is sleeping
+    tail_++;
+    control_->tail.store(tail_, std::memory_order_seq_cst);
+    if (control_->writer_waiting.load(std::memory_order_seq_cst))
+        futex_wake(&control_->tail, 1);
+}
+
+}
@@ -0,0 +1,401 @@
+#include "handler/stream_server.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+extern "C" {
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+}
+
+#include "utility.hpp"
+
+namespace ipc {
+
+StreamServer::StreamServer(std::string path)
+        : parameters_(std::make_tuple(std::move(path), std::nullopt)), unix_(true) {}
+
+StreamServer::StreamServer(std::string address, std::uint16_t port)
+        : parameters_(std::make_tuple(std::move(address), port)), unix_(false) {}
+
+StreamServer::~StreamServer() {
+    // Close sockets if open
+    if (sfd_ != -1) {
+        StreamServer::close();
+    }
+}
+
+bool StreamServer::open() {
+    // Check if socket is already open
+    if (sfd_ != -1)
+        return true;
+
+    if (!create_server()) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool StreamServer::create_server() {
+    // Open socket depending on type
+    sfd_ = socket(unix_ ? AF_UNIX : AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (sfd_ == -1) {
+        perror("StreamServer::create_server (socket)");
+        return false;
+    }
+
+    if (unix_) {
+        // Construct unix server socket and remove old socket files
+        sockaddr_un s_addr{};
+        s_addr.sun_family = AF_UNIX;
+        strncpy(s_addr.sun_path, std::get<0>(parameters_).c_str(), sizeof(s_addr.sun_path) - 1);
+        address_ = s_addr;
+        remove(s_addr.sun_path);
+
+        // Bind socket for listing
+        if (bind(sfd_, reinterpret_cast<const sockaddr *>(&s_addr), sizeof(sockaddr_un)) == -1) {
+            perror("StreamServer::create_server (bind)");
+            return false;
+        }
+    } else {
+        int option = 1;
+        setsockopt(sfd_, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+
+        // Construct internet server socket
+        sockaddr_in s_addr{};
+        s_addr.sin_family = AF_INET;
+        s_addr.sin_addr.s_addr = INADDR_ANY;
+        s_addr.sin_port = htons(*std::get<1>(parameters_));
+        address_ = s_addr;
+
+        // Bind socket for listing
+        if (bind(sfd_, reinterpret_cast<const sockaddr *>(&s_addr), sizeof(sockaddr_in)) == -1) {
+            perror("StreamServer::create_server (bind)");
+            return false;
+        }
+    }
+
+    // Listen for incoming socket connections
+    if (listen(sfd_, BACKLOG) == -1) {
+        perror("StreamServer::create_server (listen)");
+        return false;
+    }
+
+    // Create epoll instance, the listening socket is marked by a null pointer
+    efd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (efd_ == -1) {
+        perror("StreamServer::create_server (epoll_create1)");
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (epoll_ctl(efd_, EPOLL_CTL_ADD, sfd_, &event) == -1) {
+        perror("StreamServer::create_server (epoll_ctl)");
+        return false;
+    }
+
+    return true;
+}
+
+bool StreamServer::close() {
+    // Check if socket is already closed
+    if (sfd_ == -1)
+        return false;
+
+    // Close all clients
+    for (const auto &client: clients_)
+        ::close(client->fd);
+    clients_.clear();
+    next_ = 0;
+
+    // Close epoll and socket
+    if (efd_ != -1)
+        ::close(efd_);
+    ::close(sfd_);
+
+    // Remove file only for unix
+    if (unix_)
+        remove(std::get<0>(address_).sun_path);
+
+    efd_ = -1;
+    sfd_ = -1;
+
+    return true;
+}
+
+bool StreamServer::is_open() const {
+    return sfd_ != -1;
+}
+
+int StreamServer::poll_events(int timeout) {
+    const auto res = epoll_wait(efd_, events_.data(), MAX_EVENTS, timeout);
+    if (res == -1) {
+        if (errno == EINTR)
+            return 0;
+
+        perror("StreamServer::poll_events (epoll_wait)");
+        return -1;
+    }
+
+    for (int i = 0; i < res; ++i) {
+        const auto client = static_cast<Client *>(events_[i].data.ptr);
+        if (client == nullptr) {
+            accept_clients();
+            continue;
+        }
+
+        // Hang ups are readable, too, so the next receive notices them
+        client->readable = true;
+    }
+
+    return res;
+}
+
+void StreamServer::accept_clients() {
+    while (true) {
+        const auto fd = ::accept4(sfd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno != EAGAIN && errno != EINTR)
+                perror("StreamServer::accept_clients (accept)");
+            return;
+        }
+
+        auto client = std::make_unique<Client>();
+        client->fd = fd;
+
+        // Level triggered, so clients which still have data are reported again
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.ptr = client.get();
+        if (epoll_ctl(efd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+            perror("StreamServer::accept_clients (epoll_ctl)");
+            ::close(fd);
+            continue;
+        }
+
+        clients_.push_back(std::move(client));
+    }
+}
+
+void StreamServer::remove_client(std::size_t index) {
+    // Closing the socket removes it from epoll
+    ::close(clients_[index]->fd);
+    clients_.erase(clients_.begin() + static_cast<std::ptrdiff_t>(index));
+
+    // Continue with the client, which moved into this position
+    if (next_ > index)
+        next_--;
+    if (next_ >= clients_.size())
+        next_ = 0;
+}
+
+bool StreamServer::pending() const {
+    return std::any_of(clients_.begin(), clients_.end(), [](const auto &client) {
+        return client->readable || buffered(*client);
+    });
+}
+
+bool StreamServer::await_data() {
+    // Check if socket is open
+    if (sfd_ == -1)
+        return false;
+
+    // Complete frames are already buffered or clients are known to be readable
+    if (pending())
+        return true;
+
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return poll_events(0) > 0 && pending(); }))
+        return true;
+
+    if (!may_block())
+        return false;
+
+    // Wait for events and block until one is available
+    return poll_events(WAIT_TIME) > 0 && pending();
+}
+
+bool StreamServer::has_data() const {
+    // Check if socket is open
+    if (sfd_ == -1)
+        return false;
+
+    // Complete frames are already buffered or clients are known to be readable
+    if (pending())
+        return true;
+
+    // Check events and block for 1ms without taking them
+    epoll_event event{};
+    const auto res = epoll_wait(efd_, &event, 1, 1);
+    if (res == -1 && errno != EINTR)
+        perror("StreamServer::has_data (epoll_wait)");
+
+    return res > 0;
+}
+
+int StreamServer::descriptor() const {
+    // Epoll is readable while the listening socket or any client is readable
+    return efd_;
+}
+
+bool StreamServer::write(const IDataObject &) {
+    return false;
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> StreamServer::receive(Client &client) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Receive at most once, so every client gets its turn
+    for (auto received = false;; received = true) {
+        const auto available = client.end - client.begin;
+
+        if (available >= header_size) {
+            // Deserialize header of the next frame
+            const auto optional = DataHeader::deserialize(&client.buffer[client.begin], header_size);
+            if (!optional || optional->get_body_size() > MAX_BODY_SIZE) {
+                // Framing is lost, so drop everything received so far
+                client.begin = client.end = 0;
+                return CommunicationError::INVALID_HEADER;
+            }
+
+            // Take the frame directly from the buffer if it is complete
+            const auto header = *optional;
+            const auto frame_size = header_size + header.get_body_size();
+            if (available >= frame_size) {
+                const auto body = &client.buffer[client.begin + header_size];
+                client.begin += frame_size;
+                return std::make_tuple(header, body);
+            }
+
+            // Grow the buffer once for frames larger than it, the memory is kept for later frames
+            if (frame_size > client.buffer.size())
+                client.buffer.resize(frame_size);
+        }
+
+        if (received || !client.readable)
+            return CommunicationError::NO_DATA_AVAILABLE;
+
+        // Move the partial frame to the front to make room for more data
+        if (client.begin > 0) {
+            std::memmove(client.buffer.data(), &client.buffer[client.begin], available);
+            client.begin = 0;
+            client.end = available;
+        }
+
+        // Read as much as possible with a single call
+        const auto space = client.buffer.size() - client.end;
+        const auto result = recv(client.fd, &client.buffer[client.end], space, 0);
+        if (result == -1) {
+            client.readable = false;
+            if (errno == EAGAIN || errno == EINTR)
+                return CommunicationError::NO_DATA_AVAILABLE;
+
+            perror("StreamServer::receive (recv)");
+            return CommunicationError::CONNECTION_CLOSED;
+        }
+
+        // We expect at least 1 byte every time we read
+        if (result == 0)
+            return CommunicationError::CONNECTION_CLOSED;
+
+        // Only a full buffer means that more data may be waiting, otherwise epoll reports it again
+        client.end += result;
+        client.readable = static_cast<std::size_t>(result) == space;
+    }
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> StreamServer::receive() {
+    // Check if socket is open
+    if (sfd_ == -1)
+        return CommunicationError::CONNECTION_CLOSED;
+
+    // Refresh readable clients once if a whole round didn't return a message
+    for (auto round = 0; round < 2; ++round) {
+        auto remaining = clients_.size();
+        while (remaining > 0 && !clients_.empty()) {
+            const auto index = next_;
+            auto &client = *clients_[index];
+            remaining--;
+
+            const auto message = receive(client);
+            if (std::holds_alternative<CommunicationError>(message)) {
+                const auto error = std::get<CommunicationError>(message);
+
+                // Disconnected clients only affect themselves
+                if (error == CommunicationError::CONNECTION_CLOSED) {
+                    remove_client(index);
+                    continue;
+                }
+
+                next_ = (index + 1) % clients_.size();
+                if (error == CommunicationError::NO_DATA_AVAILABLE)
+                    continue;
+
+                return error;
+            }
+
+            // Continue with the next client on the next read
+            next_ = (index + 1) % clients_.size();
+            return message;
+        }
+
+        if (round == 0 && poll_events(0) <= 0)
+            break;
+    }
+
+    return CommunicationError::NO_DATA_AVAILABLE;
+}
+
+bool StreamServer::buffered(const Client &client) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if the header of the next frame is complete
+    const auto available = client.end - client.begin;
+    if (available < header_size)
+        return false;
+
+    // Invalid headers are reported by the next read
+    const auto optional = DataHeader::deserialize(&client.buffer[client.begin], header_size);
+    return !optional || available >= header_size + optional->get_body_size();
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> StreamServer::read() {
+    // Receive message into the buffer of the next client
+    const auto message = receive();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObject>(body)) {
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> StreamServer::read_view() {
+    // Receive message into the buffer of the next client, the view is valid until the next read
+    const auto message = receive();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    const auto body = deserialize_data_object_view(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObjectView>(body)) {
+        return std::make_tuple(header, std::get<DataObjectView>(body));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+}
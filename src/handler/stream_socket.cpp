@@ -1,11 +1,17 @@
 #include "handler/stream_socket.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
 #include <utility>
 
 extern "C" {
 #include <arpa/inet.h>
 #include <netinet/tcp.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 }
 
@@ -13,13 +19,16 @@ extern "C" {
 
 namespace ipc {
 
-StreamSocket::StreamSocket(std::string path, bool server)
-        : parameters_(std::make_tuple(std::move(path), std::nullopt)),
-          server_(server), unix_(true) {}
+/// User data of the multishot receive.
+static constexpr std::uint64_t RECEIVE_REQUEST = 1;
 
-StreamSocket::StreamSocket(std::string address, std::uint16_t port, bool server)
-        : parameters_(std::make_tuple(std::move(address), port)),
-          server_(server), unix_(false) {}
+StreamSocket::StreamSocket(std::string path, bool server, Mode mode)
+        : parameters_(std::make_tuple(std::move(path), std::nullopt)), server_(server), unix_(true), mode_(mode),
+          memory_files_(mode == Mode::MEMORY_FILES), uring_(mode == Mode::URING) {}
+
+StreamSocket::StreamSocket(std::string address, std::uint16_t port, bool server, Mode mode)
+        : parameters_(std::make_tuple(std::move(address), port)), server_(server), unix_(false), mode_(mode),
+          memory_files_(mode == Mode::MEMORY_FILES), uring_(mode == Mode::URING) {}
 
 StreamSocket::~StreamSocket() {
     // Close socket if open
@@ -33,6 +42,12 @@ bool StreamSocket::open() {
     if (sfd_ != -1)
         return true;
 
+    // Descriptors can't be passed to other hosts
+    if (memory_files_ && !unix_) {
+        fprintf(stderr, "StreamSocket::open (Memory files require a unix domain socket)\n");
+        return false;
+    }
+
     // Create server or client
     if (server_) {
         if (!create_server()) {
@@ -44,6 +59,12 @@ bool StreamSocket::open() {
         return false;
     }
 
+    // The server creates its ring for every accepted client
+    if (uring_ && !server_ && !ring_.open()) {
+        close();
+        return false;
+    }
+
     return true;
 }
 
@@ -164,6 +185,11 @@ bool StreamSocket::close() {
     sfd_ = -1;
     cfd_ = -1;
 
+    // Drop partially received frames
+    begin_ = end_ = 0;
+    release_memory_files(true);
+    ring_.close();
+
     return true;
 }
 
@@ -182,8 +208,13 @@ bool StreamSocket::accept() {
         cfd_ = -1;
     }
 
+    // Drop partially received frames of the old client, its receive is cancelled with the ring
+    begin_ = end_ = 0;
+    release_memory_files(true);
+    ring_.close();
+
     // Check if new clients are available
-    auto res = poll(sfd_, WAIT_TIME);
+    auto res = poll(sfd_, accept_time());
     if (res == -1) {
         perror("StreamSocket::accept (poll)");
         return false;
@@ -201,6 +232,15 @@ bool StreamSocket::accept() {
     }
 
     cfd_ = res;
+
+    // Data of the client is received into buffers of the ring from now on
+    if (uring_ && (!ring_.open() || !ring_.provide_buffers(RING_BUFFERS, RING_BUFFER_SIZE) || !arm_ring())) {
+        ring_.close();
+        ::close(cfd_);
+        cfd_ = -1;
+        return false;
+    }
+
     return true;
 }
 
@@ -211,6 +251,33 @@ bool StreamSocket::await_data() {
             return false;
     }
 
+    // Complete frames are already buffered
+    if (buffered())
+        return true;
+
+    if (uring_) {
+        // Completions are checked without any syscall
+        if (spin([this] { return ring_.ready(); }))
+            return true;
+
+        if (!may_block())
+            return false;
+
+        // Block until the next completion arrives
+        const auto res = ring_.wait(WAIT_TIME);
+        if (res == -1)
+            perror("StreamSocket::await_data (io_uring_enter)");
+
+        return res > 0;
+    }
+
+    // Spin before blocking depending on the wait policy
+    if (spin([this] { return poll(cfd_, 0) > 0; }))
+        return true;
+
+    if (!may_block())
+        return false;
+
     // Poll events and block until one is available
     const auto res = poll(cfd_, WAIT_TIME);
     if (res == -1)
@@ -224,6 +291,14 @@ bool StreamSocket::has_data() const {
     if (cfd_ == -1)
         return false;
 
+    // Complete frames are already buffered
+    if (buffered())
+        return true;
+
+    // Data is already received by the ring
+    if (uring_)
+        return ring_.ready();
+
     // Poll events and block for 1ms
     const auto res = poll(cfd_, 1);
     if (res == -1)
@@ -232,6 +307,14 @@ bool StreamSocket::has_data() const {
     return res > 0;
 }
 
+int StreamSocket::descriptor() const {
+    // The listening socket until a client is accepted, the ring of the client afterwards
+    if (cfd_ == -1)
+        return server_ ? sfd_ : -1;
+
+    return uring_ ? ring_.descriptor() : cfd_;
+}
+
 bool StreamSocket::write(const IDataObject &obj) {
     constexpr auto header_size = sizeof(DataHeader);
 
@@ -239,75 +322,234 @@ bool StreamSocket::write(const IDataObject &obj) {
     if (sfd_ == -1)
         return false;
 
-    // Serialize body
+    // Describe body as parts, only small parts are serialized behind the header
     const auto timestamp = get_timestamp();
-    const auto size = obj.serialize(&buffer_[header_size], BUFFER_SIZE - header_size);
-    if (size == -1)
+    std::array<iovec, MAX_PARTS> vectors{};
+    const auto parts = obj.serialize_parts(&buffer_[header_size], BUFFER_SIZE - header_size, &vectors[1], MAX_PARTS - 1);
+    if (parts == -1)
+        return false;
+
+    const auto size = total_size(&vectors[1], parts);
+    if (size > MAX_BODY_SIZE)
         return false;
 
+    // Pass large bodies as memory file instead of copying them through the socket
+    if (memory_files_ && size >= MEMORY_FILE_SIZE)
+        return write_memory_file(obj.get_type(), size, timestamp, &vectors[1], parts);
+
     last_id_++;
     DataHeader header(last_id_, obj.get_type(), size, timestamp);
 
     // Serialize header
     header.serialize(buffer_.data(), header_size);
+    vectors[0] = {buffer_.data(), header_size};
 
-    // Write data into socket
-    const auto res = send(sfd_, buffer_.data(), header_size + size, 0);
+    // Write header and body without staging the payload
+    const auto res = write_vectors(vectors.data(), parts + 1);
     if (res == -1)
-        perror("StreamSocket::write (send)");
+        perror("StreamSocket::write (writev)");
 
     return res != -1;
 }
 
-std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> StreamSocket::read() {
+bool StreamSocket::write_memory_file(DataType type, std::uint32_t size, std::int64_t timestamp,
+                                     iovec *parts, int count) {
     constexpr auto header_size = sizeof(DataHeader);
 
-    // Check if pipe is open
+    // Write body into a sealed memory file
+    const auto fd = create_sealed_memory(parts, count);
+    if (fd == -1) {
+        perror("StreamSocket::write_memory_file (memfd_create)");
+        return false;
+    }
+
+    last_id_++;
+    DataHeader header(last_id_, DataType::MEMORY_FILE, header_size, timestamp);
+    DataHeader body(0, type, size, timestamp);
+
+    // Only the header of the frame and of the body are written, the parts are already consumed
+    header.serialize(buffer_.data(), header_size);
+    body.serialize(&buffer_[header_size], header_size);
+    iovec vector{buffer_.data(), 2 * header_size};
+
+    // Attach descriptor to the frame
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+    msghdr message{};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    const auto cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    ssize_t res;
+    do {
+        res = sendmsg(sfd_, &message, 0);
+    } while (res == -1 && errno == EINTR);
+
+    // Descriptor was sent with the first byte, so the rest of the frame is written normally
+    if (res != -1 && static_cast<std::size_t>(res) < vector.iov_len) {
+        vector.iov_base = &buffer_[res];
+        vector.iov_len -= res;
+        res = write_all(sfd_, &vector, 1);
+    }
+
+    // The receiver holds its own reference to the file
+    ::close(fd);
+
+    if (res == -1)
+        perror("StreamSocket::write_memory_file (sendmsg)");
+
+    return res != -1;
+}
+
+unsigned int StreamSocket::write_batch(const std::vector<const IDataObject *> &objects) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if socket is open
+    if (sfd_ == -1)
+        return 0;
+
+    // Headers and small parts are serialized into the batch buffer, payloads are referenced directly
+    batch_.resize(objects.size() * BUFFER_SIZE);
+    vectors_.resize(objects.size() * MAX_PARTS);
+    const auto timestamp = get_timestamp();
+
+    // Write all collected messages, the kernel limits the amount of parts per call
+    int count = 0;
+    const auto flush = [this, &count] {
+        for (int offset = 0; offset < count; offset += IOV_MAX) {
+            const auto res = write_vectors(&vectors_[offset], std::min(count - offset, IOV_MAX));
+            if (res == -1) {
+                perror("StreamSocket::write_batch (writev)");
+                return false;
+            }
+        }
+
+        count = 0;
+        return true;
+    };
+
+    unsigned int amount = 0;
+    for (const auto obj: objects) {
+        const auto buffer = &batch_[amount * BUFFER_SIZE];
+        const auto parts = obj->serialize_parts(&buffer[header_size], BUFFER_SIZE - header_size,
+                                                &vectors_[count + 1], MAX_PARTS - 1);
+        if (parts == -1)
+            break;
+
+        const auto size = total_size(&vectors_[count + 1], parts);
+        if (size > MAX_BODY_SIZE)
+            break;
+
+        // Large bodies are passed as memory file behind the messages collected so far
+        if (memory_files_ && size >= MEMORY_FILE_SIZE) {
+            // Flushing resets the vectors, so the parts of the body are taken first
+            std::array<iovec, MAX_PARTS> body{};
+            std::copy_n(&vectors_[count + 1], parts, body.begin());
+
+            if (!flush())
+                return 0;
+
+            // Messages before the body were written already
+            if (!write_memory_file(obj->get_type(), size, timestamp, body.data(), parts))
+                return amount;
+
+            amount++;
+            continue;
+        }
+
+        last_id_++;
+        DataHeader header(last_id_, obj->get_type(), size, timestamp);
+        header.serialize(buffer, header_size);
+        vectors_[count] = {buffer, header_size};
+
+        count += parts + 1;
+        amount++;
+    }
+
+    if (!flush())
+        return 0;
+
+    return amount;
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> StreamSocket::receive() {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if socket is open
     if (cfd_ == -1)
         return CommunicationError::CONNECTION_CLOSED;
 
-    // Read data from pipe
-    long result;
-    unsigned int amount = 0;
-    do {
-        result = recv(cfd_, &buffer_[amount], header_size - amount, 0);
-        if (result == -1) {
-            if (errno == EAGAIN) {
-                // Some part of the header was already read -> waiting for rest
-                if (amount > 0)
-                    continue;
+    // Memory file of the previous frame is not used anymore
+    release_memory_files(false);
 
-                // Nothing read yet -> no data available
-                return CommunicationError::NO_DATA_AVAILABLE;
+    while (true) {
+        const auto available = end_ - begin_;
+
+        if (available >= header_size) {
+            // Deserialize header of the next frame
+            const auto optional = DataHeader::deserialize(&receive_buffer_[begin_], header_size);
+            if (!optional || optional->get_body_size() > MAX_BODY_SIZE) {
+                // Framing is lost, so drop everything received so far
+                begin_ = end_ = 0;
+                return CommunicationError::INVALID_HEADER;
             }
 
-            perror("StreamSocket::read (recv)");
-            return CommunicationError::READ_ERROR;
+            // Take the frame directly from the buffer if it is complete
+            const auto header = *optional;
+            const auto frame_size = header_size + header.get_body_size();
+            if (available >= frame_size) {
+                const auto body = &receive_buffer_[begin_ + header_size];
+                begin_ += frame_size;
+
+                if (header.get_type() == DataType::MEMORY_FILE)
+                    return map_memory_file(header, body);
+
+                return std::make_tuple(header, body);
+            }
+
+            // Grow the buffer once for frames larger than it, the memory is kept for later frames
+            if (frame_size > receive_buffer_.size())
+                receive_buffer_.resize(frame_size);
         }
 
-        // We expect at least 1 byte every time we read
-        if (result == 0)
-            return CommunicationError::CONNECTION_CLOSED;
+        // Move the partial frame to the front to make room for more data
+        if (begin_ > 0) {
+            std::memmove(receive_buffer_.data(), &receive_buffer_[begin_], available);
+            begin_ = 0;
+            end_ = available;
+        }
 
-        amount += result;
-    } while (amount < header_size);
+        // Take the next chunk received by the ring
+        if (uring_) {
+            const auto error = receive_ring();
+            if (error)
+                return *error;
 
-    // Deserialize header
-    const auto optional = DataHeader::deserialize(buffer_.data(), header_size);
-    if (!optional)
-        return CommunicationError::INVALID_HEADER;
+            continue;
+        }
 
-    const auto header = *optional;
+        // Read as much as possible with a single call, descriptors of memory files arrive with their frame
+        iovec vector{&receive_buffer_[end_], receive_buffer_.size() - end_};
+        alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int) * MAX_FILES)> control;
+        msghdr message{};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
 
-    // Read data from pipe
-    amount = 0;
-    while (amount < header.get_body_size()) {
-        result = recv(cfd_, &buffer_[amount], header.get_body_size() - amount, 0);
+        const auto result = recvmsg(cfd_, &message, MSG_CMSG_CLOEXEC);
         if (result == -1) {
+            // Partial frames are kept until the rest arrives
             if (errno == EAGAIN)
-                continue;
+                return CommunicationError::NO_DATA_AVAILABLE;
 
-            perror("StreamSocket::read (recv)");
+            perror("StreamSocket::receive (recvmsg)");
             return CommunicationError::READ_ERROR;
         }
 
@@ -315,14 +557,178 @@ std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> StreamSocke
         if (result == 0)
             return CommunicationError::CONNECTION_CLOSED;
 
-        amount += result;
+        end_ += result;
+        collect_memory_files(message);
+    }
+}
+
+std::optional<CommunicationError> StreamSocket::receive_ring() {
+    const auto next = ring_.peek();
+    if (next == nullptr)
+        return CommunicationError::NO_DATA_AVAILABLE;
+
+    const auto completion = *next;
+    ring_.seen();
+
+    // The peer closed the socket
+    if (completion.res == 0)
+        return CommunicationError::CONNECTION_CLOSED;
+
+    // The kernel stops the receive once it runs out of buffers, so restart it
+    if ((completion.flags & IORING_CQE_F_MORE) == 0 && !arm_ring())
+        return CommunicationError::READ_ERROR;
+
+    if (completion.res < 0) {
+        if (completion.res == -ENOBUFS)
+            return CommunicationError::NO_DATA_AVAILABLE;
+
+        errno = -completion.res;
+        perror("StreamSocket::receive_ring (recv)");
+        return CommunicationError::READ_ERROR;
+    }
+
+    // Copy the chunk behind the buffered data and give the buffer back right away
+    const auto size = static_cast<std::size_t>(completion.res);
+    if (end_ + size > receive_buffer_.size())
+        receive_buffer_.resize(end_ + size);
+
+    std::memcpy(&receive_buffer_[end_], ring_.provided(completion.flags), size);
+    ring_.recycle(completion.flags);
+    end_ += size;
+
+    return std::nullopt;
+}
+
+bool StreamSocket::arm_ring() {
+    const auto sqe = ring_.prepare(IORING_OP_RECV, cfd_, RECEIVE_REQUEST);
+    if (sqe == nullptr)
+        return false;
+
+    // Every chunk completes separately inside a buffer selected by the kernel
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = 0;
+
+    return ring_.submit() != -1;
+}
+
+ssize_t StreamSocket::write_vectors(iovec *vectors, int count) {
+    return uring_ ? ring_.write_all(sfd_, vectors, count) : write_all(sfd_, vectors, count);
+}
+
+std::variant<std::tuple<DataHeader, const std::byte *>, CommunicationError> StreamSocket::map_memory_file(
+        const DataHeader &header, const std::byte *data) {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if the descriptor of the frame was received
+    if (file_count_ == 0 || header.get_body_size() != header_size) {
+        fprintf(stderr, "StreamSocket::map_memory_file (Missing memory file)\n");
+        return CommunicationError::INVALID_DATA;
     }
 
-    const auto body = deserialize_data_object(header.get_type(), buffer_.data(), header.get_body_size());
+    const auto fd = files_[0];
+    std::copy(&files_[1], &files_[file_count_], files_.begin());
+    file_count_--;
+
+    // Deserialize header of the passed body
+    const auto optional = DataHeader::deserialize(data, header_size);
+    if (!optional || !optional->is_valid() || optional->get_body_size() > MAX_BODY_SIZE) {
+        ::close(fd);
+        return CommunicationError::INVALID_HEADER;
+    }
+
+    // Map body read only, the mapping keeps the file alive
+    const auto size = optional->get_body_size();
+    const auto address = map_sealed_memory(fd, size);
+    ::close(fd);
+
+    if (address == nullptr) {
+        fprintf(stderr, "StreamSocket::map_memory_file (Invalid memory file)\n");
+        return CommunicationError::INVALID_DATA;
+    }
+
+    mapping_ = address;
+    mapping_size_ = size;
+
+    return std::make_tuple(DataHeader(header.get_id(), optional->get_type(), size, header.get_timestamp()), address);
+}
+
+void StreamSocket::collect_memory_files(msghdr &message) {
+    for (auto cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+            continue;
+
+        const auto amount = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (std::size_t i = 0; i < amount; ++i) {
+            int fd;
+            std::memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+
+            // Too many descriptors without their frame, so the frame will report the missing one
+            if (file_count_ == MAX_FILES) {
+                ::close(fd);
+                continue;
+            }
+
+            files_[file_count_++] = fd;
+        }
+    }
+}
+
+void StreamSocket::release_memory_files(bool pending) {
+    if (mapping_ != nullptr) {
+        munmap(const_cast<std::byte *>(mapping_), mapping_size_);
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+    }
+
+    if (pending) {
+        for (std::size_t i = 0; i < file_count_; ++i)
+            ::close(files_[i]);
+
+        file_count_ = 0;
+    }
+}
+
+bool StreamSocket::buffered() const {
+    constexpr auto header_size = sizeof(DataHeader);
+
+    // Check if the header of the next frame is complete
+    const auto available = end_ - begin_;
+    if (available < header_size)
+        return false;
+
+    // Invalid headers are reported by the next read
+    const auto optional = DataHeader::deserialize(&receive_buffer_[begin_], header_size);
+    return !optional || available >= header_size + optional->get_body_size();
+}
+
+std::variant<std::tuple<DataHeader, DataObject>, CommunicationError> StreamSocket::read() {
+    // Receive message into buffer
+    const auto message = receive();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    auto body = deserialize_data_object(header.get_type(), data, header.get_body_size());
 
     if (std::holds_alternative<DataObject>(body)) {
-        const auto obj = std::get<DataObject>(body);
-        return std::make_tuple(header, obj);
+        return std::make_tuple(header, std::get<DataObject>(std::move(body)));
+    } else {
+        return std::get<CommunicationError>(body);
+    }
+}
+
+std::variant<std::tuple<DataHeader, DataObjectView>, CommunicationError> StreamSocket::read_view() {
+    // Receive message into buffer, the view is valid until the next read
+    const auto message = receive();
+    if (std::holds_alternative<CommunicationError>(message))
+        return std::get<CommunicationError>(message);
+
+    const auto [header, data] = std::get<std::tuple<DataHeader, const std::byte *>>(message);
+    const auto body = deserialize_data_object_view(header.get_type(), data, header.get_body_size());
+
+    if (std::holds_alternative<DataObjectView>(body)) {
+        return std::make_tuple(header, std::get<DataObjectView>(body));
     } else {
         return std::get<CommunicationError>(body);
     }
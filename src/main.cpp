@@ -3,20 +3,31 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <optional>
 #include <sstream>
 #include <thread>
 
+#include "benchmark/allocation.hpp"
+#include "benchmark/clients.hpp"
 #include "benchmark/execution.hpp"
 #include "benchmark/latency.hpp"
+#include "benchmark/reactor.hpp"
 #include "benchmark/realworld.hpp"
+#include "benchmark/sink.hpp"
 #include "benchmark/throughput.hpp"
 #include "benchmark/stats.hpp"
+#include "handler/broadcast_memory.hpp"
 #include "handler/datagram_socket.hpp"
 #include "handler/dbus.hpp"
+#include "handler/event_fd.hpp"
 #include "handler/fifo.hpp"
 #include "handler/message_queue.hpp"
+#include "handler/mpmc_memory.hpp"
+#include "handler/seqpacket_socket.hpp"
 #include "handler/shared_file.hpp"
 #include "handler/shared_memory.hpp"
+#include "handler/spsc_memory.hpp"
+#include "handler/stream_server.hpp"
 #include "handler/stream_socket.hpp"
 #include "object/binary_data.hpp"
 #include "utility.hpp"
@@ -35,22 +46,66 @@ static volatile bool stop = false;
 std::shared_ptr<ipc::ICommunicationHandler> create_handler(const std::string &type, const std::string &path, bool reader) {
     if (type == "dbus") {
         return std::make_shared<ipc::DBus>("ipc." + path + ".server", reader);
+    } else if (type == "dbus-memfd") {
+        return std::make_shared<ipc::DBus>("ipc." + path + ".server", reader, ipc::DBus::MEMORY_FILES);
+    } else if (type == "dbus-peer") {
+        return std::make_shared<ipc::DBus>("ipc." + path + ".server", reader, ipc::DBus::PEER);
+    } else if (type == "dbus-batch") {
+        return std::make_shared<ipc::DBus>("ipc." + path + ".server", reader, ipc::DBus::BATCHING);
+    } else if (type == "dbus-peer-batch") {
+        return std::make_shared<ipc::DBus>("ipc." + path + ".server", reader, ipc::DBus::PEER | ipc::DBus::BATCHING);
     } else if (type == "fifo") {
         return std::make_shared<ipc::Fifo>("/tmp/" + path, reader);
+    } else if (type == "fifo-uring") {
+        return std::make_shared<ipc::Fifo>("/tmp/" + path, reader, ipc::Fifo::Mode::URING);
+    } else if (type == "fifo-splice") {
+        return std::make_shared<ipc::Fifo>("/tmp/" + path, reader, ipc::Fifo::Mode::SPLICE);
+    } else if (type == "fifo-packet") {
+        return std::make_shared<ipc::Fifo>("/tmp/" + path, reader, ipc::Fifo::Mode::PACKET);
     } else if (type == "queue") {
         return std::make_shared<ipc::MessageQueue>("/" + path, reader);
+    } else if (type == "queue-deep") {
+        return std::make_shared<ipc::MessageQueue>("/" + path, reader, ipc::MessageQueue::MAX_QUEUE_SIZE);
     } else if (type == "dgram") {
         return std::make_shared<ipc::DatagramSocket>("/tmp/" + path, reader);
+    } else if (type == "dgram-uring") {
+        return std::make_shared<ipc::DatagramSocket>("/tmp/" + path, reader, ipc::DatagramSocket::Mode::URING);
     } else if (type == "stream") {
         return std::make_shared<ipc::StreamSocket>("/tmp/" + path, reader);
+    } else if (type == "stream-memfd") {
+        return std::make_shared<ipc::StreamSocket>("/tmp/" + path, reader, ipc::StreamSocket::Mode::MEMORY_FILES);
+    } else if (type == "stream-uring") {
+        return std::make_shared<ipc::StreamSocket>("/tmp/" + path, reader, ipc::StreamSocket::Mode::URING);
+    } else if (type == "stream-multi") {
+        if (reader)
+            return std::make_shared<ipc::StreamServer>("/tmp/" + path);
+        return std::make_shared<ipc::StreamSocket>("/tmp/" + path, false);
+    } else if (type == "eventfd") {
+        return std::make_shared<ipc::EventFd>("/tmp/" + path, reader);
+    } else if (type == "seqpacket") {
+        return std::make_shared<ipc::SeqPacketSocket>("/tmp/" + path, reader);
     } else if (type == "udp") {
-        return std::make_shared<ipc::DatagramSocket>(path, 8080, reader);
+        return std::make_shared<ipc::DatagramSocket>(path, std::uint16_t{8080}, reader);
     } else if (type == "tcp") {
-        return std::make_shared<ipc::StreamSocket>(path, 8080, reader);
+        return std::make_shared<ipc::StreamSocket>(path, std::uint16_t{8080}, reader);
+    } else if (type == "tcp-multi") {
+        if (reader)
+            return std::make_shared<ipc::StreamServer>(path, std::uint16_t{8080});
+        return std::make_shared<ipc::StreamSocket>(path, std::uint16_t{8080}, false);
     } else if (type == "memory") {
         return std::make_shared<ipc::SharedMemory>(path, reader, false);
     } else if (type == "mapped") {
         return std::make_shared<ipc::SharedMemory>("/tmp/" + path, reader, true);
+    } else if (type == "spsc") {
+        return std::make_shared<ipc::SpscMemory>(path, reader, false);
+    } else if (type == "spsc-mapped") {
+        return std::make_shared<ipc::SpscMemory>("/tmp/" + path, reader, true);
+    } else if (type == "spsc-doorbell") {
+        return std::make_shared<ipc::SpscMemory>(path, reader, false, "/tmp/" + path + "-doorbell");
+    } else if (type == "mpmc") {
+        return std::make_shared<ipc::MpmcMemory>(path, reader);
+    } else if (type == "broadcast") {
+        return std::make_shared<ipc::BroadcastMemory>(path, reader);
     } else if (type == "file") {
         return std::make_shared<ipc::SharedFile>("/tmp/" + path, reader);
     }
@@ -58,6 +113,39 @@ std::shared_ptr<ipc::ICommunicationHandler> create_handler(const std::string &ty
     return nullptr;
 }
 
+/**
+ * Check whether forked writers may share an opened handler of the type.
+ *
+ * @param type Type of the handler.
+ *
+ * @return True, if every message is written atomically by a single call or slot claim.
+ * @remark Message queues and datagram sockets still split large bodies into fragments, which would interleave.
+ */
+bool supports_writers(const std::string &type) {
+    return type == "queue" || type == "queue-deep" || type == "dgram" || type == "udp" || type == "mpmc";
+}
+
+/**
+ * Parse the wait policy by its name.
+ *
+ * @param name Name of the wait policy.
+ *
+ * @return Wait policy or nothing if name is invalid.
+ */
+std::optional<ipc::WaitPolicy> parse_wait_policy(const std::string &name) {
+    if (name == "block") {
+        return ipc::WaitPolicy::BLOCK;
+    } else if (name == "spin") {
+        return ipc::WaitPolicy::SPIN;
+    } else if (name == "busy") {
+        return ipc::WaitPolicy::BUSY_POLL;
+    } else if (name == "poll") {
+        return ipc::WaitPolicy::POLL;
+    }
+
+    return std::nullopt;
+}
+
 void run_client(const std::shared_ptr<ipc::ICommunicationHandler> &handler) {
     int i = 1;
     while (!stop && handler->is_open()) {
@@ -135,8 +223,9 @@ void run_server(const std::shared_ptr<ipc::ICommunicationHandler> &handler) {
     }
 }
 
-int run_latency(ipc::ICommunicationHandler &handler, unsigned int iterations, unsigned int delay, bool readonly) {
-    ipc::benchmark::LatencyBenchmark bench(iterations, delay, readonly);
+int run_latency(ipc::ICommunicationHandler &handler, unsigned int iterations, unsigned int delay,
+                ipc::WaitPolicy policy, unsigned int spin_count, const std::string &policy_name, bool readonly) {
+    ipc::benchmark::LatencyBenchmark bench(iterations, delay, readonly, policy, spin_count);
     if (!bench.setup(handler))
         return EXIT_FAILURE;
 
@@ -157,6 +246,10 @@ int run_latency(ipc::ICommunicationHandler &handler, unsigned int iterations, un
 
         std::cout << "Iterations:   " << count << std::endl
                   << "Delay:        " << delay << "ms" << std::endl
+                  << "Policy:       " << policy_name;
+        if (policy == ipc::WaitPolicy::SPIN)
+            std::cout << " (" << spin_count << ')';
+        std::cout << std::endl
                   << "Minimum:      " << stats.minimum / 1000.0 << "us" << std::endl
                   << "Minimum':     " << stats.filtered_minimum / 1000.0 << "us" << std::endl
                   << "1st Quartile: " << stats.first_quartile / 1000.0 << "us" << std::endl
@@ -177,8 +270,9 @@ int run_latency(ipc::ICommunicationHandler &handler, unsigned int iterations, un
     return EXIT_SUCCESS;
 }
 
-int run_throughput(ipc::ICommunicationHandler &handler, unsigned int iterations, unsigned int body_size, bool readonly) {
-    ipc::benchmark::ThroughputBenchmark bench(iterations, body_size, readonly);
+int run_throughput(ipc::ICommunicationHandler &handler, unsigned int iterations, unsigned int body_size,
+                   unsigned int writers, unsigned int batch, bool view, bool readonly) {
+    ipc::benchmark::ThroughputBenchmark bench(iterations, body_size, readonly, writers, batch, view);
     if (!bench.setup(handler))
         return EXIT_FAILURE;
 
@@ -200,6 +294,43 @@ int run_throughput(ipc::ICommunicationHandler &handler, unsigned int iterations,
 
         std::cout << "Iterations: " << count << std::endl
                   << "Size:       " << size << " Byte (" << size + sizeof(ipc::DataHeader) << " Byte)" << std::endl
+                  << "Writers:    " << bench.get_writers() << std::endl
+                  << "Batch:      " << bench.get_batch() << std::endl
+                  << "Read:       " << (bench.is_view() ? "view" : "read") << std::endl
+                  << "Misses:     " << count - received << std::endl
+                  << "Time:       " << total_time << "ms" << std::endl
+                  << "Throughput: " << throughput << "KiB/s" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int run_sink(ipc::ICommunicationHandler &handler, unsigned int iterations, unsigned int body_size, bool splice,
+             const std::string &sink_path, bool readonly) {
+    ipc::benchmark::SinkBenchmark bench(iterations, body_size, readonly, splice, sink_path);
+    if (!bench.setup(handler))
+        return EXIT_FAILURE;
+
+    std::cout << "Running Sink benchmark..." << std::endl;
+    const auto success = bench.run(handler);
+    std::cout << "Benchmark completed!" << std::endl;
+
+    bench.cleanup(handler);
+
+    if (!success)
+        return EXIT_FAILURE;
+
+    if (readonly) {
+        const auto count = bench.get_iterations();
+        const auto received = bench.get_received();
+        const auto size = bench.get_size();
+        const auto total_time = bench.get_total_time();
+        const auto throughput = bench.get_throughput();
+
+        std::cout << "Iterations: " << count << std::endl
+                  << "Size:       " << size << " Byte (" << size + sizeof(ipc::DataHeader) << " Byte)" << std::endl
+                  << "Transfer:   " << (bench.is_splice() ? "splice" : "copy") << std::endl
+                  << "Sink:       " << bench.get_path() << std::endl
                   << "Misses:     " << count - received << std::endl
                   << "Time:       " << total_time << "ms" << std::endl
                   << "Throughput: " << throughput << "KiB/s" << std::endl;
@@ -208,6 +339,116 @@ int run_throughput(ipc::ICommunicationHandler &handler, unsigned int iterations,
     return EXIT_SUCCESS;
 }
 
+int run_reactor(const std::vector<std::shared_ptr<ipc::ICommunicationHandler>> &handlers, unsigned int iterations,
+                unsigned int body_size, unsigned int reconnect, bool readonly) {
+    ipc::benchmark::ReactorBenchmark bench(iterations, body_size, readonly, reconnect);
+    if (!bench.setup(handlers))
+        return EXIT_FAILURE;
+
+    std::cout << "Running Reactor benchmark..." << std::endl;
+    const auto success = bench.run(handlers);
+    std::cout << "Benchmark completed!" << std::endl;
+
+    bench.cleanup(handlers);
+
+    if (!success)
+        return EXIT_FAILURE;
+
+    if (readonly) {
+        const auto count = bench.get_iterations() * handlers.size();
+        const auto received = bench.get_received();
+        const auto size = bench.get_size();
+
+        std::cout << "Handlers:    " << handlers.size() << std::endl
+                  << "Iterations:  " << bench.get_iterations() << " per handler" << std::endl
+                  << "Size:        " << size << " Byte (" << size + sizeof(ipc::DataHeader) << " Byte)" << std::endl
+                  << "Reconnect:   " << bench.get_reconnect() << std::endl
+                  << "Disconnects: " << bench.get_disconnects() << std::endl
+                  << "Misses:      " << count - received << std::endl
+                  << "Waits:       " << bench.get_waits() << std::endl
+                  << "Time:        " << bench.get_total_time() << "ms" << std::endl
+                  << "Throughput:  " << bench.get_throughput() << "KiB/s" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int run_clients(ipc::ICommunicationHandler &handler, unsigned int iterations, unsigned int body_size,
+                unsigned int clients, bool readonly) {
+    ipc::benchmark::ClientsBenchmark bench(iterations, body_size, readonly, clients);
+    if (!bench.setup(handler))
+        return EXIT_FAILURE;
+
+    std::cout << "Running Clients benchmark..." << std::endl;
+    const auto success = bench.run(handler);
+    std::cout << "Benchmark completed!" << std::endl;
+
+    bench.cleanup(handler);
+
+    if (!success)
+        return EXIT_FAILURE;
+
+    if (readonly) {
+        const auto count = bench.get_iterations() * bench.get_clients();
+        const auto received = bench.get_received();
+        const auto size = bench.get_size();
+
+        // 99th percentile of every client, which received anything
+        std::vector<double> percentiles{};
+        for (auto latencies: bench.get_results()) {
+            if (latencies.empty())
+                continue;
+
+            std::sort(latencies.begin(), latencies.end());
+            percentiles.push_back(ipc::benchmark::quantile(latencies, 0.99));
+        }
+
+        std::cout << "Clients:    " << bench.get_clients() << std::endl
+                  << "Iterations: " << bench.get_iterations() << " per client" << std::endl
+                  << "Size:       " << size << " Byte (" << size + sizeof(ipc::DataHeader) << " Byte)" << std::endl
+                  << "Misses:     " << count - received << std::endl
+                  << "Time:       " << bench.get_total_time() << "ms" << std::endl
+                  << "Throughput: " << bench.get_throughput() << "KiB/s" << std::endl;
+
+        if (!percentiles.empty()) {
+            const auto stats = ipc::benchmark::Statistics::compute(percentiles);
+            std::cout << "P99 Min:    " << stats.minimum / 1000.0 << "us" << std::endl
+                      << "P99 Median: " << stats.median / 1000.0 << "us" << std::endl
+                      << "P99 Max:    " << stats.maximum / 1000.0 << "us" << std::endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int run_allocation(ipc::ICommunicationHandler &handler, unsigned int iterations, unsigned int body_size, bool readonly) {
+    ipc::benchmark::AllocationBenchmark bench(iterations, body_size, readonly);
+    if (!bench.setup(handler))
+        return EXIT_FAILURE;
+
+    std::cout << "Running Allocation benchmark..." << std::endl;
+    const auto success = bench.run(handler);
+    std::cout << "Benchmark completed!" << std::endl;
+
+    bench.cleanup(handler);
+
+    if (readonly) {
+        const auto count = bench.get_iterations();
+        const auto received = bench.get_received();
+        const auto size = bench.get_size();
+
+        std::cout << "Iterations:  " << count << std::endl
+                  << "Size:        " << size << " Byte (" << size + sizeof(ipc::DataHeader) << " Byte)" << std::endl
+                  << "Misses:      " << count - received << std::endl
+                  << "Warmup:      " << ipc::benchmark::AllocationBenchmark::WARMUP << std::endl
+                  << "Allocations: " << bench.get_allocations() << std::endl
+                  << "Per message: " << bench.get_allocations_per_message() << std::endl
+                  << "Counted:     operator new only, malloc of C libraries like libdbus is not counted" << std::endl;
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int run_execution_time(ipc::ICommunicationHandler &handler, unsigned int iterations, unsigned int body_size, unsigned int delay, bool readonly) {
     ipc::benchmark::ExecutionTimeBenchmark bench(iterations, body_size, delay, readonly);
     if (!bench.setup(handler))
@@ -311,19 +552,69 @@ int main(int argc, char *argv[]) {
     /*
      *  ./ipc <kind> <type> <mode> <parameter...>
      *
-     *  <kind> = normal, latency, throughput, execution, realworld
+     *  <kind> = normal, latency, throughput, sink, clients, reactor, allocation, execution, realworld
      *  <type> = dbus, fifo, ...
      *  <mode> = reader, writer
      *  <parameter> = benchmark specific
+     *
+     *  ./ipc latency <type> <mode> <iterations> <delay> [block|spin|busy|poll] [spin count]
+     *  ./ipc throughput <type> <mode> <iterations> <size> [writers] [batch] [read|view]
+     *  ./ipc sink <type> <mode> <iterations> <size> [copy|splice] [sink path]
+     *  ./ipc-allocation allocation <type> <mode> <iterations> <size>
+     *  ./ipc clients <type> <mode> <iterations> <size> <clients>
+     *  ./ipc reactor <type,type,...> <mode> <iterations> <size> [reconnect]
      */
 
     const std::string kind(argv[1]);
     const std::string type(argv[2]);
     const auto mode = strcmp(argv[3], "reader") == 0;
 
-    const std::string path = type == "udp" || type == "tcp" ? "127.0.0.1" : "ipc-handler";
+    // The reactor benchmark reads from several handlers at once, every handler gets its own path
+    if (kind == "reactor") {
+        if (argc < 6) {
+            std::cout << "Missing arguments" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const auto iterations = std::stoul(argv[4]);
+        const auto body_size = std::stoul(argv[5]);
+        const auto reconnect = argc > 6 ? std::stoul(argv[6]) : 0;
+
+        std::vector<std::shared_ptr<ipc::ICommunicationHandler>> handlers{};
+        std::stringstream ss(type);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            const auto handler_path = item == "udp" || item == "tcp" ? "127.0.0.1"
+                                                                      : "ipc-handler-" + std::to_string(handlers.size());
+            auto handler = item == "fifo-splice" ? nullptr : create_handler(item, handler_path, mode);
+            if (!handler) {
+                std::cout << "Invalid parameter" << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            std::cout << "Loading handler... (" << item << ", " << handler_path << ')' << std::endl;
+            handlers.push_back(std::move(handler));
+        }
+
+        auto temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::cout << "Start: " << ctime(&temp);
+
+        const auto res = run_reactor(handlers, iterations, body_size, reconnect, mode);
+
+        temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::cout << "End: " << ctime(&temp);
+        return res;
+    }
+
+    const std::string path = type == "udp" || type == "tcp" || type == "tcp-multi" ? "127.0.0.1" : "ipc-handler";
     std::cout << "Path: " << path << std::endl;
 
+    // The pipe references the written pages, so only benchmarks which never change their data may splice
+    if (type == "fifo-splice" && kind != "throughput" && kind != "sink") {
+        std::cout << "Handler fifo-splice is only supported by the throughput and sink benchmark" << std::endl;
+        return EXIT_FAILURE;
+    }
+
     auto handler = create_handler(type, path, mode);
     if (!handler) {
         std::cout << "Invalid parameter" << std::endl;
@@ -369,10 +660,19 @@ int main(int argc, char *argv[]) {
         const auto iterations = std::stoul(argv[4]);
         const auto delay = std::stoul(argv[5]);
 
+        // Optional wait policy for the reader
+        const std::string policy_name = argc > 6 ? argv[6] : "block";
+        const auto spin_count = argc > 7 ? std::stoul(argv[7]) : ipc::ICommunicationHandler::SPIN_COUNT;
+        const auto policy = parse_wait_policy(policy_name);
+        if (!policy) {
+            std::cout << "Invalid wait policy" << std::endl;
+            return EXIT_FAILURE;
+        }
+
         auto temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
         std::cout << "Start: " << ctime(&temp);
 
-        const auto res = run_latency(*handler, iterations, delay, mode);
+        const auto res = run_latency(*handler, iterations, delay, *policy, spin_count, policy_name, mode);
 
         temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
         std::cout << "End: " << ctime(&temp);
@@ -383,13 +683,81 @@ int main(int argc, char *argv[]) {
             return EXIT_FAILURE;
         }
 
+        const auto iterations = std::stoul(argv[4]);
+        const auto body_size = std::stoul(argv[5]);
+        const auto writers = argc > 6 ? std::stoul(argv[6]) : 1;
+        const auto batch = argc > 7 ? std::stoul(argv[7]) : 1;
+        const auto view = argc > 8 && strcmp(argv[8], "view") == 0;
+
+        if (writers < 1 || batch < 1) {
+            std::cout << "Writers and batch must be at least 1" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // Rings, cursors and shared buffers of the other handlers are owned by a single writer
+        if (writers > 1 && !supports_writers(type)) {
+            std::cout << "Handler " << type << " doesn't support multiple writers" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        auto temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::cout << "Start: " << ctime(&temp);
+
+        const auto res = run_throughput(*handler, iterations, body_size, writers, batch, view, mode);
+
+        temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::cout << "End: " << ctime(&temp);
+        return res;
+    } else if (kind == "sink") {
+        if (argc < 6) {
+            std::cout << "Missing arguments" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const auto iterations = std::stoul(argv[4]);
+        const auto body_size = std::stoul(argv[5]);
+        const auto splice = argc > 6 && strcmp(argv[6], "splice") == 0;
+        const std::string sink_path = argc > 7 ? argv[7] : "/dev/null";
+
+        auto temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::cout << "Start: " << ctime(&temp);
+
+        const auto res = run_sink(*handler, iterations, body_size, splice, sink_path, mode);
+
+        temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::cout << "End: " << ctime(&temp);
+        return res;
+    } else if (kind == "clients") {
+        if (argc < 7) {
+            std::cout << "Missing arguments" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const auto iterations = std::stoul(argv[4]);
+        const auto body_size = std::stoul(argv[5]);
+        const auto clients = std::stoul(argv[6]);
+
+        auto temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::cout << "Start: " << ctime(&temp);
+
+        const auto res = run_clients(*handler, iterations, body_size, clients, mode);
+
+        temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::cout << "End: " << ctime(&temp);
+        return res;
+    } else if (kind == "allocation") {
+        if (argc < 6) {
+            std::cout << "Missing arguments" << std::endl;
+            return EXIT_FAILURE;
+        }
+
         const auto iterations = std::stoul(argv[4]);
         const auto body_size = std::stoul(argv[5]);
 
         auto temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
         std::cout << "Start: " << ctime(&temp);
 
-        const auto res = run_throughput(*handler, iterations, body_size, mode);
+        const auto res = run_allocation(*handler, iterations, body_size, mode);
 
         temp = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
         std::cout << "End: " << ctime(&temp);
@@ -26,6 +26,23 @@ int BinaryData::serialize(std::byte *buffer, unsigned int size) const {
     return static_cast<int>(total_size);
 }
 
+int BinaryData::serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const {
+    // Not enough space in buffer or parts
+    if (sizeof(std::uint32_t) > size || count < 2)
+        return -1;
+
+    // Only the length is serialized, the data is referenced directly
+    const std::uint32_t length = data_.size();
+    std::memcpy(buffer, &length, sizeof(length));
+
+    parts[0] = {buffer, sizeof(length)};
+    if (length == 0)
+        return 1;
+
+    parts[1] = {const_cast<std::byte *>(data_.data()), length};
+    return 2;
+}
+
 std::optional<BinaryData> BinaryData::deserialize(const std::byte *buffer, unsigned int size) {
     constexpr auto header_size = sizeof(std::uint32_t);
 
@@ -51,7 +68,7 @@ std::optional<BinaryData> BinaryData::deserialize(const std::byte *buffer, unsig
     data.resize(length);
     std::memcpy(data.data(), &buffer[offset], length);
 
-    return BinaryData(data);
+    return BinaryData(std::move(data));
 }
 
 std::ostream &operator<<(std::ostream &outs, const BinaryData &data) {
@@ -0,0 +1,85 @@
+#include "object/binary_data_view.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <vector>
+
+namespace ipc {
+
+BinaryDataView::BinaryDataView(const std::byte *data, std::size_t size)
+        : data_(data), size_(size) {}
+
+BinaryDataView::BinaryDataView(const BinaryData &data)
+        : data_(data.get_data().data()), size_(data.get_data().size()) {}
+
+int BinaryDataView::serialize(std::byte *buffer, unsigned int size) const {
+    const auto total_size = sizeof(std::uint32_t) + size_;
+
+    // Not enough space in buffer
+    if (total_size > size)
+        return -1;
+
+    auto offset = 0;
+    const std::uint32_t length = size_;
+    std::memcpy(&buffer[offset], &length, sizeof(length));
+    offset += sizeof(length);
+
+    if (length > 0)
+        std::memcpy(&buffer[offset], data_, length);
+
+    return static_cast<int>(total_size);
+}
+
+int BinaryDataView::serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const {
+    // Not enough space in buffer or parts
+    if (sizeof(std::uint32_t) > size || count < 2)
+        return -1;
+
+    // Only the length is serialized, the data is referenced directly
+    const std::uint32_t length = size_;
+    std::memcpy(buffer, &length, sizeof(length));
+
+    parts[0] = {buffer, sizeof(length)};
+    if (length == 0)
+        return 1;
+
+    parts[1] = {const_cast<std::byte *>(data_), length};
+    return 2;
+}
+
+BinaryData BinaryDataView::to_owned() const {
+    return BinaryData(std::vector<std::byte>(data_, data_ + size_));
+}
+
+std::optional<BinaryDataView> BinaryDataView::deserialize(const std::byte *buffer, unsigned int size) {
+    constexpr auto header_size = sizeof(std::uint32_t);
+
+    // Not enough space in buffer
+    if (size < header_size)
+        return std::nullopt;
+
+    std::uint32_t length;
+    std::memcpy(&length, buffer, sizeof(length));
+
+    // Not enough space in buffer
+    if (size < header_size + length)
+        return std::nullopt;
+
+    return BinaryDataView(&buffer[header_size], length);
+}
+
+std::ostream &operator<<(std::ostream &outs, const BinaryDataView &data) {
+    std::ios_base::fmtflags f(outs.flags());
+    outs << std::setfill('0') << std::hex << '(';
+
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        outs << std::setw(sizeof(char) * 2) << static_cast<int>(data.data()[i]);
+    }
+
+    outs << ')';
+    outs.flags(f);
+
+    return outs;
+}
+
+}
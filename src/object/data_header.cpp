@@ -5,12 +5,12 @@
 
 namespace ipc {
 
-DataHeader::DataHeader(std::uint32_t id, DataType type, std::uint16_t body_size, std::int64_t timestamp)
+DataHeader::DataHeader(std::uint32_t id, DataType type, std::uint32_t body_size, std::int64_t timestamp)
         : id_(id), type_(type), body_size_(body_size), timestamp_(timestamp) {}
 
 int DataHeader::serialize(std::byte *buffer, const unsigned int size) const {
     constexpr auto header_size = sizeof(DataHeader);
-    static_assert(header_size == 16, "Size of header should match");
+    static_assert(header_size == 24, "Size of header should match");
 
     // Not enough space in buffer
     if (size < header_size)
@@ -23,7 +23,7 @@ int DataHeader::serialize(std::byte *buffer, const unsigned int size) const {
 
 std::optional<DataHeader> DataHeader::deserialize(const std::byte *buffer, unsigned int size) {
     constexpr auto header_size = sizeof(DataHeader);
-    static_assert(header_size == 16, "Size of header should match");
+    static_assert(header_size == 24, "Size of header should match");
 
     // Not enough space in buffer
     if (size < header_size)
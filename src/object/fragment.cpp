@@ -0,0 +1,73 @@
+#include "object/fragment.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ipc {
+
+void Fragment::assign(const iovec *parts, unsigned int count, std::uint32_t offset, std::uint32_t length) {
+    parts_ = parts;
+    count_ = count;
+    offset_ = offset;
+    length_ = length;
+}
+
+int Fragment::serialize(std::byte *buffer, unsigned int size) const {
+    const auto total_size = PREFIX_SIZE + length_;
+
+    // Not enough space in buffer
+    if (total_size > size)
+        return -1;
+
+    std::memcpy(buffer, &offset_, sizeof(offset_));
+    auto position = PREFIX_SIZE;
+
+    // Copy the slice, which may span multiple parts of the message
+    std::size_t skip = offset_;
+    for (unsigned int i = 0; i < count_ && position < total_size; ++i) {
+        if (skip >= parts_[i].iov_len) {
+            skip -= parts_[i].iov_len;
+            continue;
+        }
+
+        const auto amount = std::min<std::size_t>(parts_[i].iov_len - skip, total_size - position);
+        std::memcpy(&buffer[position], static_cast<const std::byte *>(parts_[i].iov_base) + skip, amount);
+        position += amount;
+        skip = 0;
+    }
+
+    return static_cast<int>(total_size);
+}
+
+int Fragment::serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const {
+    // Not enough space in buffer or parts
+    if (PREFIX_SIZE > size || count < 1)
+        return -1;
+
+    // Only the offset is serialized, the slice is referenced directly
+    std::memcpy(buffer, &offset_, sizeof(offset_));
+    parts[0] = {buffer, PREFIX_SIZE};
+
+    unsigned int used = 1;
+    std::size_t skip = offset_;
+    std::size_t remaining = length_;
+    for (unsigned int i = 0; i < count_ && remaining > 0; ++i) {
+        if (skip >= parts_[i].iov_len) {
+            skip -= parts_[i].iov_len;
+            continue;
+        }
+
+        // Not enough parts, so copy the whole fragment instead
+        if (used == count)
+            return IDataObject::serialize_parts(buffer, size, parts, count);
+
+        const auto amount = std::min(parts_[i].iov_len - skip, remaining);
+        parts[used++] = {static_cast<std::byte *>(parts_[i].iov_base) + skip, amount};
+        remaining -= amount;
+        skip = 0;
+    }
+
+    return static_cast<int>(used);
+}
+
+}
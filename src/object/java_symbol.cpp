@@ -36,6 +36,33 @@ int JavaSymbol::serialize(std::byte *buffer, unsigned int size) const {
     return static_cast<int>(obj_size);
 }
 
+int JavaSymbol::serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const {
+    constexpr auto header_size = sizeof(JavaSymbol::address_)
+                                 + sizeof(JavaSymbol::length_) + sizeof(std::uint32_t);
+
+    // Not enough space in buffer or parts
+    if (header_size > size || count < 2)
+        return -1;
+
+    // Only address, length and name length are serialized, the name is referenced directly
+    auto offset = 0;
+    std::memcpy(&buffer[offset], &address_, sizeof(address_));
+    offset += sizeof(address_);
+
+    std::memcpy(&buffer[offset], &length_, sizeof(length_));
+    offset += sizeof(length_);
+
+    const std::uint32_t length = symbol_.length();
+    std::memcpy(&buffer[offset], &length, sizeof(length));
+
+    parts[0] = {buffer, header_size};
+    if (length == 0)
+        return 1;
+
+    parts[1] = {const_cast<char *>(symbol_.data()), length};
+    return 2;
+}
+
 std::optional<JavaSymbol> JavaSymbol::deserialize(const std::byte *buffer, unsigned int size) {
     constexpr auto header_size = sizeof(JavaSymbol::address_)
                                  + sizeof(JavaSymbol::length_) + sizeof(std::uint32_t);
@@ -70,7 +97,7 @@ std::optional<JavaSymbol> JavaSymbol::deserialize(const std::byte *buffer, unsig
     symbol.resize(symbol_length);
     std::memcpy(symbol.data(), &buffer[offset], symbol_length);
 
-    return JavaSymbol(address, length, symbol);
+    return JavaSymbol(address, length, std::move(symbol));
 }
 
 std::ostream &operator<<(std::ostream &outs, const JavaSymbol &symbol) {
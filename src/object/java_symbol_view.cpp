@@ -0,0 +1,116 @@
+#include "object/java_symbol_view.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <string>
+
+namespace ipc {
+
+JavaSymbolView::JavaSymbolView(std::uint64_t address, std::uint32_t length, std::string_view symbol)
+        : address_(address), length_(length), symbol_(symbol) {}
+
+JavaSymbolView::JavaSymbolView(const JavaSymbol &symbol)
+        : address_(symbol.get_address()), length_(symbol.get_length()), symbol_(symbol.get_symbol()) {}
+
+int JavaSymbolView::serialize(std::byte *buffer, unsigned int size) const {
+    constexpr auto header_size = sizeof(JavaSymbolView::address_)
+                                 + sizeof(JavaSymbolView::length_) + sizeof(std::uint32_t);
+    static_assert(header_size == 16, "Size should match");
+
+    const auto obj_size = header_size + symbol_.length();
+
+    // Not enough space in buffer
+    if (obj_size > size)
+        return -1;
+
+    auto offset = 0;
+    std::memcpy(&buffer[offset], &address_, sizeof(address_));
+    offset += sizeof(address_);
+
+    std::memcpy(&buffer[offset], &length_, sizeof(length_));
+    offset += sizeof(length_);
+
+    std::uint32_t length = symbol_.length();
+    std::memcpy(&buffer[offset], &length, sizeof(length));
+    offset += sizeof(length);
+
+    if (length > 0)
+        std::memcpy(&buffer[offset], symbol_.data(), length);
+
+    return static_cast<int>(obj_size);
+}
+
+int JavaSymbolView::serialize_parts(std::byte *buffer, unsigned int size, iovec *parts, unsigned int count) const {
+    constexpr auto header_size = sizeof(JavaSymbolView::address_)
+                                 + sizeof(JavaSymbolView::length_) + sizeof(std::uint32_t);
+
+    // Not enough space in buffer or parts
+    if (header_size > size || count < 2)
+        return -1;
+
+    // Only address, length and name length are serialized, the name is referenced directly
+    auto offset = 0;
+    std::memcpy(&buffer[offset], &address_, sizeof(address_));
+    offset += sizeof(address_);
+
+    std::memcpy(&buffer[offset], &length_, sizeof(length_));
+    offset += sizeof(length_);
+
+    const std::uint32_t length = symbol_.length();
+    std::memcpy(&buffer[offset], &length, sizeof(length));
+
+    parts[0] = {buffer, header_size};
+    if (length == 0)
+        return 1;
+
+    parts[1] = {const_cast<char *>(symbol_.data()), length};
+    return 2;
+}
+
+JavaSymbol JavaSymbolView::to_owned() const {
+    return JavaSymbol(address_, length_, std::string(symbol_));
+}
+
+std::optional<JavaSymbolView> JavaSymbolView::deserialize(const std::byte *buffer, unsigned int size) {
+    constexpr auto header_size = sizeof(JavaSymbolView::address_)
+                                 + sizeof(JavaSymbolView::length_) + sizeof(std::uint32_t);
+    static_assert(header_size == 16, "Size should match");
+
+    // Not enough space in buffer
+    if (size < header_size)
+        return std::nullopt;
+
+    std::uint64_t address;
+    std::uint32_t length, symbol_length;
+
+    auto offset = 0;
+    std::memcpy(&address, &buffer[offset], sizeof(address));
+    offset += sizeof(address);
+
+    std::memcpy(&length, &buffer[offset], sizeof(length));
+    offset += sizeof(length);
+
+    std::memcpy(&symbol_length, &buffer[offset], sizeof(symbol_length));
+    offset += sizeof(symbol_length);
+
+    // Not enough space in buffer
+    if (size < header_size + symbol_length)
+        return std::nullopt;
+
+    const auto symbol = reinterpret_cast<const char *>(&buffer[offset]);
+    return JavaSymbolView(address, length, std::string_view(symbol, symbol_length));
+}
+
+std::ostream &operator<<(std::ostream &outs, const JavaSymbolView &symbol) {
+    std::ios_base::fmtflags f(outs.flags());
+
+    outs << std::setfill('0') << std::hex
+         << "(0x" << std::setw(sizeof(symbol.get_address()) * 2) << symbol.get_address()
+         << ", 0x" << std::setw(sizeof(symbol.get_length()) * 2) << symbol.get_length()
+         << ", \"" << symbol.get_symbol() << "\")";
+    outs.flags(f);
+
+    return outs;
+}
+
+}
@@ -1,11 +1,20 @@
 #include "utility.hpp"
 
+#include <cerrno>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
+#include <utility>
 
 extern "C" {
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
 #include <sys/poll.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
 }
 
 namespace ipc {
@@ -37,12 +46,121 @@ int poll(int fd, int timeout) {
     return ::poll(&pfd, 1, timeout);
 }
 
+int poll_write(int fd, int timeout) {
+    pollfd pfd{};
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+
+    // Poll events and block for 'timeout'
+    return ::poll(&pfd, 1, timeout);
+}
+
+ssize_t write_all(int fd, iovec *vectors, int count) {
+    ssize_t total = 0;
+
+    while (count > 0) {
+        const auto res = writev(fd, vectors, count);
+        if (res == -1) {
+            if (errno == EINTR)
+                continue;
+
+            return -1;
+        }
+
+        total += res;
+        count = advance_vectors(vectors, count, res);
+    }
+
+    return total;
+}
+
+int advance_vectors(iovec *&vectors, int count, std::size_t written) {
+    // Skip parts which were written completely and adjust the partial one
+    while (count > 0 && written >= vectors->iov_len) {
+        written -= vectors->iov_len;
+        vectors++;
+        count--;
+    }
+
+    if (count > 0) {
+        vectors->iov_base = static_cast<std::byte *>(vectors->iov_base) + written;
+        vectors->iov_len -= written;
+    }
+
+    return count;
+}
+
+std::size_t total_size(const iovec *vectors, int count) {
+    std::size_t total = 0;
+    for (int i = 0; i < count; ++i)
+        total += vectors[i].iov_len;
+
+    return total;
+}
+
+int create_sealed_memory(iovec *vectors, int count) {
+    const auto fd = memfd_create("ipc-body", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd == -1)
+        return -1;
+
+    // Write content and forbid any later change of data or size
+    if (write_all(fd, vectors, count) == -1
+        || fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1) {
+        const auto error = errno;
+        close(fd);
+        errno = error;
+        return -1;
+    }
+
+    return fd;
+}
+
+const std::byte *map_sealed_memory(int fd, std::size_t size) {
+    // The sender must not be able to change the content while it is read
+    const auto seals = fcntl(fd, F_GET_SEALS);
+    if (seals == -1 || (seals & (F_SEAL_SHRINK | F_SEAL_WRITE)) != (F_SEAL_SHRINK | F_SEAL_WRITE))
+        return nullptr;
+
+    struct stat info{};
+    if (fstat(fd, &info) == -1 || static_cast<std::size_t>(info.st_size) < size)
+        return nullptr;
+
+    // Pages are only faulted in if the reader touches them
+    const auto address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED)
+        return nullptr;
+
+    return static_cast<const std::byte *>(address);
+}
+
+int futex_wait(std::atomic<std::uint32_t> *address, std::uint32_t expected, int timeout) {
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "Futex word must be 32 bit");
+
+    timespec wait_time{};
+    wait_time.tv_sec = timeout / 1000;
+    wait_time.tv_nsec = (timeout % 1000) * 1000 * 1000;
+
+    // Sleep only if the word still has the expected value (no private flag, word is shared)
+    return static_cast<int>(syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(address), FUTEX_WAIT,
+                                    expected, timeout < 0 ? nullptr : &wait_time, nullptr, 0));
+}
+
+int futex_wake(std::atomic<std::uint32_t> *address, int count) {
+    return static_cast<int>(syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(address), FUTEX_WAKE,
+                                    count, nullptr, nullptr, 0));
+}
+
 std::variant<DataObject, CommunicationError> deserialize_data_object(DataType type, const std::byte *buffer, unsigned int size) {
     // Handle each type differently
     switch (type) {
         case DataType::INVALID:
             return CommunicationError::INVALID_DATA;
 
+        case DataType::FRAGMENT:
+        case DataType::MEMORY_FILE:
+            // Fragments and memory files are resolved by the handler and never deserialized on their own
+            return CommunicationError::INVALID_DATA;
+
         case DataType::PING: {
             // Deserialize Ping
             const auto data = Ping::deserialize(buffer, size);
@@ -54,16 +172,59 @@ std::variant<DataObject, CommunicationError> deserialize_data_object(DataType ty
 
         case DataType::JAVA_SYMBOL_LOOKUP: {
             // Deserialize Java Symbols
-            const auto data = JavaSymbol::deserialize(buffer, size);
+            auto data = JavaSymbol::deserialize(buffer, size);
             if (!data)
                 return CommunicationError::INVALID_DATA;
 
-            return *data;
+            return std::move(*data);
         }
 
         case DataType::BINARY_DATA: {
             // Deserialize Binary data
-            const auto data = BinaryData::deserialize(buffer, size);
+            auto data = BinaryData::deserialize(buffer, size);
+            if (!data)
+                return CommunicationError::INVALID_DATA;
+
+            return std::move(*data);
+        }
+    }
+
+    // Unknown or invalid type
+    return CommunicationError::UNKNOWN_DATA;
+}
+
+std::variant<DataObjectView, CommunicationError> deserialize_data_object_view(DataType type, const std::byte *buffer, unsigned int size) {
+    // Handle each type differently
+    switch (type) {
+        case DataType::INVALID:
+            return CommunicationError::INVALID_DATA;
+
+        case DataType::FRAGMENT:
+        case DataType::MEMORY_FILE:
+            // Fragments and memory files are resolved by the handler and never deserialized on their own
+            return CommunicationError::INVALID_DATA;
+
+        case DataType::PING: {
+            // Deserialize Ping
+            const auto data = Ping::deserialize(buffer, size);
+            if (!data)
+                return CommunicationError::INVALID_DATA;
+
+            return *data;
+        }
+
+        case DataType::JAVA_SYMBOL_LOOKUP: {
+            // Deserialize view of Java Symbols
+            const auto data = JavaSymbolView::deserialize(buffer, size);
+            if (!data)
+                return CommunicationError::INVALID_DATA;
+
+            return *data;
+        }
+
+        case DataType::BINARY_DATA: {
+            // Deserialize view of Binary data
+            const auto data = BinaryDataView::deserialize(buffer, size);
             if (!data)
                 return CommunicationError::INVALID_DATA;
 
@@ -75,4 +236,4 @@ std::variant<DataObject, CommunicationError> deserialize_data_object(DataType ty
     return CommunicationError::UNKNOWN_DATA;
 }
 
-}
\ No newline at end of file
+}